@@ -1,403 +1,350 @@
 #include "Enemy.h"
+#include "EnemyPool.h"
+#include "ProjectilePool.h"
+#include "EnemyPerception.h"
+#include "JobSystem.h"
 #include <cmath>
-#include <cstdlib>
 #include <algorithm>
 
-// Helper function to get random float between min and max
-float randomFloatRange(float min, float max) {
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+EnemyTuning::EnemyTuning(float rad, float spd)
+    : speed(spd), maxHealth(75),
+      detectionRange(0.8f), shootingRange(0.5f), meleeRange(0.15f), wanderRadius(0.4f),
+      playerPredictionTime(0.3f), collisionRadius(rad * 1.2f), pushForce(1.2f),
+      meleeCooldown(1.5f), meleeDamage(15), arrowDamage(8), wanderInterval(2.0f), shootingCooldown(1.8f) {
 }
 
-Enemy::Enemy(float startX, float startY, float rad, float spd)
-    : x(startX), y(startY), radius(rad), speed(spd), 
-      maxHealth(75), currentHealth(75), isDead(false),
-      detectionRange(0.8f), shootingRange(0.5f), meleeRange(0.15f), wanderRadius(0.4f),
-      homeX(startX), homeY(startY), 
-      lastPlayerX(0), lastPlayerY(0), playerPredictionTime(0.3f),
-      collisionRadius(rad * 1.2f), pushForce(0.02f),
-      meleeTimer(0.0f), meleeCooldown(1.5f), canMelee(true), meleeDamage(15),
-      wanderTimer(0.0f), wanderInterval(2.0f), targetX(startX), targetY(startY),
-      shootingTimer(0.0f), shootingCooldown(1.8f), canShoot(true),
-      currentState(WANDERING), stateTimer(0.0f) {
-    
-    // Initialize with a random wander target
-    updateWanderTarget();
+EnemyBrain::EnemyBrain(float startX, float startY, uint64_t rngSeed)
+    : homeX(startX), homeY(startY),
+      lastPlayerX(0), lastPlayerY(0),
+      meleeTimer(0.0f), canMelee(true),
+      wanderTimer(0.0f), targetX(startX), targetY(startY),
+      shootingTimer(0.0f), canShoot(true),
+      stateTimer(0.0f), lastSwordSwing(0), rng(rngSeed) {
 }
 
-void Enemy::update(float playerX, float playerY, float deltaTime) {
-    if (isDead) return;
+const size_t Enemy::UPDATE_BATCH_SIZE;
 
-    // Calculate distance to player
-    float dx = playerX - x;
-    float dy = playerY - y;
-    float distToPlayer = std::sqrt(dx * dx + dy * dy);
-
-    // Update timers
-    if (!canShoot) {
-        shootingTimer += deltaTime;
-        if (shootingTimer >= shootingCooldown) {
-            shootingTimer = 0.0f;
-            canShoot = true;
-        }
-    }
-    
-    if (!canMelee) {
-        meleeTimer += deltaTime;
-        if (meleeTimer >= meleeCooldown) {
-            meleeTimer = 0.0f;
-            canMelee = true;
-        }
-    }
-    
-    stateTimer += deltaTime;
-
-    // Update AI state based on player distance and health
-    updateAIState(playerX, playerY, distToPlayer);
-
-    // Execute behavior based on current state
-    switch (currentState) {
-        case WANDERING:
-            wander(deltaTime);
-            break;
-        case DETECTING:
-        case FOLLOWING:
-            followPlayer(playerX, playerY, deltaTime);
-            break;
-        case ATTACKING:
-            attackPlayer(playerX, playerY, deltaTime);
-            break;
-        case FLEEING:
-            fleeFromPlayer(playerX, playerY, deltaTime);
-            break;
+void EnemyDeferred::reset(size_t count) {
+    shot.resize(count);
+    hasShot.assign(count, 0);
+}
+
+void Enemy::updateAll(EnemyPool& pool, EnemyPerception& perception, EnemyDeferred& deferred, JobSystem& jobs,
+                      float playerX, float playerY, float deltaTime, ProjectilePool& projectiles) {
+    // Distances and next AI states for every enemy in one batch
+    perceiveEnemies(pool, playerX, playerY, perception);
+    deferred.reset(pool.size());
+
+    // Run each state's behavior over its bucket in parallel. Every enemy
+    // only writes its own pool entries and deferred slot.
+    for (int s = 0; s < EnemyPerception::STATE_COUNT; s++) {
+        const std::vector<uint32_t>& bucket = perception.bucket[s];
+        AIState state = static_cast<AIState>(s);
+
+        auto runBatch = [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                uint32_t i = bucket[k];
+                updateTimers(pool, i, deltaTime);
+                enterState(pool, i, state);
+
+                switch (state) {
+                    case WANDERING:
+                        wander(pool, i, deltaTime);
+                        break;
+                    case DETECTING:
+                    case FOLLOWING:
+                        followPlayer(pool, i, playerX, playerY, deltaTime);
+                        break;
+                    case ATTACKING:
+                        attackPlayer(pool, i, playerX, playerY, perception.distSq[i], deltaTime, deferred);
+                        break;
+                    case FLEEING:
+                        fleeFromPlayer(pool, i, playerX, playerY, perception.distSq[i], deltaTime);
+                        break;
+                }
+
+                // Store player position for prediction
+                pool.brain[i].lastPlayerX = playerX;
+                pool.brain[i].lastPlayerY = playerY;
+            }
+        };
+        jobs.parallelFor(bucket.size(), UPDATE_BATCH_SIZE, runBatch);
     }
 
-    // Update arrows
-    updateArrows(deltaTime);
-    
-    // Store player position for prediction
-    lastPlayerX = playerX;
-    lastPlayerY = playerY;
+    applyDeferred(pool, deferred, projectiles);
 }
 
-void Enemy::updateAIState(float playerX, float playerY, float distToPlayer) {
-    AIState newState = currentState;
-    
-    // Health-based behavior
-    float healthPercentage = getHealthPercentage();
-    
-    if (healthPercentage < 0.3f && distToPlayer < shootingRange) {
-        // Low health and player is close - flee
-        newState = FLEEING;
-    }
-    else if (distToPlayer <= meleeRange) {
-        // Very close - attack with melee
-        newState = ATTACKING;
-    }
-    else if (distToPlayer <= shootingRange) {
-        // In shooting range - attack with ranged
-        newState = ATTACKING;
+void Enemy::applyDeferred(EnemyPool& pool, const EnemyDeferred& deferred, ProjectilePool& projectiles) {
+    // Enemy index order, so the result does not depend on thread scheduling
+    for (size_t i = 0; i < pool.size(); i++) {
+        if (deferred.hasShot[i]) {
+            const EnemyDeferred::Shot& shot = deferred.shot[i];
+            projectiles.spawn(shot.x, shot.y, shot.vx, shot.vy, shot.radius,
+                              pool.tuning[i].arrowDamage, FACTION_ENEMY, pool.handleAt(i).slot);
+        }
     }
-    else if (distToPlayer <= detectionRange) {
-        // Player detected - follow
-        if (hasLineOfSight(playerX, playerY)) {
-            newState = FOLLOWING;
-        } else {
-            newState = DETECTING; // Lost line of sight, but still aware
+}
+
+void Enemy::updateTimers(EnemyPool& pool, size_t i, float deltaTime) {
+    const EnemyTuning& tuning = pool.tuning[i];
+    EnemyBrain& brain = pool.brain[i];
+
+    if (!brain.canShoot) {
+        brain.shootingTimer += deltaTime;
+        if (brain.shootingTimer >= tuning.shootingCooldown) {
+            brain.shootingTimer = 0.0f;
+            brain.canShoot = true;
         }
     }
-    else {
-        // Player not detected - wander
-        newState = WANDERING;
+
+    if (!brain.canMelee) {
+        brain.meleeTimer += deltaTime;
+        if (brain.meleeTimer >= tuning.meleeCooldown) {
+            brain.meleeTimer = 0.0f;
+            brain.canMelee = true;
+        }
     }
-    
+
+    brain.stateTimer += deltaTime;
+}
+
+void Enemy::enterState(EnemyPool& pool, size_t i, AIState newState) {
     // Reset state timer if state changed
-    if (newState != currentState) {
-        stateTimer = 0.0f;
-        currentState = newState;
+    if (newState != pool.state[i]) {
+        pool.brain[i].stateTimer = 0.0f;
+        pool.state[i] = newState;
     }
 }
 
-void Enemy::wander(float deltaTime) {
-    wanderTimer += deltaTime;
-    
+void Enemy::wander(EnemyPool& pool, size_t i, float deltaTime) {
+    const EnemyTuning& tuning = pool.tuning[i];
+    EnemyBrain& brain = pool.brain[i];
+    brain.wanderTimer += deltaTime;
+
     // Pick a new target after interval expires or if we reached current target
-    if (wanderTimer >= wanderInterval) {
-        updateWanderTarget();
-        wanderTimer = 0.0f;
+    if (brain.wanderTimer >= tuning.wanderInterval) {
+        updateWanderTarget(pool, i);
+        brain.wanderTimer = 0.0f;
     }
-    
+
     // Move toward the current wander target
-    float dx = targetX - x;
-    float dy = targetY - y;
+    float dx = brain.targetX - pool.x[i];
+    float dy = brain.targetY - pool.y[i];
     float dist = std::sqrt(dx * dx + dy * dy);
-    
+
     // If we're close enough to target, pick a new one
-    if (dist < radius * 0.5f) {
-        updateWanderTarget();
+    if (dist < pool.radius[i] * 0.5f) {
+        updateWanderTarget(pool, i);
         return;
     }
-    
+
     // Move toward target at reduced speed
-    moveTowards(targetX, targetY, speed * 0.4f, deltaTime);
+    moveTowards(pool, i, brain.targetX, brain.targetY, tuning.speed * 0.4f, deltaTime);
 }
 
-void Enemy::followPlayer(float playerX, float playerY, float deltaTime) {
+void Enemy::followPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float deltaTime) {
     // Predict where the player will be
     float predX, predY;
-    predictPlayerMovement(playerX, playerY, predX, predY);
-    
+    predictPlayerMovement(pool, i, playerX, playerY, deltaTime, predX, predY);
+
     // Move toward predicted position
-    float followSpeed = speed * 0.8f;
-    
+    float followSpeed = pool.tuning[i].speed * 0.8f;
+
     // If we lost line of sight, move to last known position
-    if (currentState == DETECTING) {
+    if (pool.state[i] == DETECTING) {
         followSpeed *= 0.6f; // Move slower when searching
-        moveTowards(lastPlayerX, lastPlayerY, followSpeed, deltaTime);
+        moveTowards(pool, i, pool.brain[i].lastPlayerX, pool.brain[i].lastPlayerY, followSpeed, deltaTime);
     } else {
-        moveTowards(predX, predY, followSpeed, deltaTime);
+        moveTowards(pool, i, predX, predY, followSpeed, deltaTime);
     }
 }
 
-void Enemy::attackPlayer(float playerX, float playerY, float deltaTime) {
+void Enemy::attackPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float distSq, float deltaTime,
+                         EnemyDeferred& deferred) {
+    const EnemyTuning& tuning = pool.tuning[i];
+    EnemyBrain& brain = pool.brain[i];
+    float x = pool.x[i];
+    float y = pool.y[i];
+
     float dx = playerX - x;
     float dy = playerY - y;
-    float distToPlayer = std::sqrt(dx * dx + dy * dy);
-    
+    float distToPlayer = std::sqrt(distSq);
+
     // Melee attack if very close
-    if (distToPlayer <= meleeRange && canMelee) {
+    if (distToPlayer <= tuning.meleeRange && brain.canMelee) {
         // Don't move, just attack
-        canMelee = false;
-        meleeTimer = 0.0f;
+        brain.canMelee = false;
+        brain.meleeTimer = 0.0f;
     }
     // Ranged attack if in shooting range
-    else if (distToPlayer <= shootingRange && canShoot) {
+    else if (distToPlayer <= tuning.shootingRange && brain.canShoot) {
         // Predict player movement for better accuracy
         float predX, predY;
-        predictPlayerMovement(playerX, playerY, predX, predY);
-        shoot(predX, predY);
-        canShoot = false;
-        shootingTimer = 0.0f;
-        
+        predictPlayerMovement(pool, i, playerX, playerY, deltaTime, predX, predY);
+        shoot(pool, i, predX, predY, deferred);
+        brain.canShoot = false;
+        brain.shootingTimer = 0.0f;
+
         // Move to maintain optimal distance
-        float optimalDistance = shootingRange * 0.7f;
+        float optimalDistance = tuning.shootingRange * 0.7f;
         if (distToPlayer < optimalDistance) {
             // Too close, back away slightly
-            moveTowards(x - dx * 0.1f, y - dy * 0.1f, speed * 0.3f, deltaTime);
-        } else if (distToPlayer > shootingRange * 0.9f) {
+            moveTowards(pool, i, x - dx * 0.1f, y - dy * 0.1f, tuning.speed * 0.3f, deltaTime);
+        } else if (distToPlayer > tuning.shootingRange * 0.9f) {
             // Too far, move closer
-            moveTowards(playerX, playerY, speed * 0.6f, deltaTime);
+            moveTowards(pool, i, playerX, playerY, tuning.speed * 0.6f, deltaTime);
         }
     }
     else {
         // Move to get into range
-        moveTowards(playerX, playerY, speed * 0.9f, deltaTime);
+        moveTowards(pool, i, playerX, playerY, tuning.speed * 0.9f, deltaTime);
     }
 }
 
-void Enemy::fleeFromPlayer(float playerX, float playerY, float deltaTime) {
+void Enemy::fleeFromPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float distSq, float deltaTime) {
+    const EnemyBrain& brain = pool.brain[i];
+    float x = pool.x[i];
+    float y = pool.y[i];
+
     // Calculate direction away from player
     float dx = x - playerX;
     float dy = y - playerY;
-    float dist = std::sqrt(dx * dx + dy * dy);
-    
+    float dist = std::sqrt(distSq);
+
     if (dist > 0) {
         dx /= dist;
         dy /= dist;
     }
-    
+
     // Flee toward home position if possible, otherwise just away from player
     float fleeX = x + dx * 0.5f;
     float fleeY = y + dy * 0.5f;
-    
+
     // Bias toward home position
     float homeWeight = 0.3f;
-    fleeX = fleeX * (1.0f - homeWeight) + homeX * homeWeight;
-    fleeY = fleeY * (1.0f - homeWeight) + homeY * homeWeight;
-    
-    moveTowards(fleeX, fleeY, speed * 1.2f, deltaTime); // Flee faster
+    fleeX = fleeX * (1.0f - homeWeight) + brain.homeX * homeWeight;
+    fleeY = fleeY * (1.0f - homeWeight) + brain.homeY * homeWeight;
+
+    moveTowards(pool, i, fleeX, fleeY, pool.tuning[i].speed * 1.2f, deltaTime); // Flee faster
 }
 
-void Enemy::moveTowards(float targetX, float targetY, float moveSpeed, float deltaTime) {
-    float dx = targetX - x;
-    float dy = targetY - y;
+void Enemy::moveTowards(EnemyPool& pool, size_t i, float targetX, float targetY, float moveSpeed, float deltaTime) {
+    float dx = targetX - pool.x[i];
+    float dy = targetY - pool.y[i];
     float dist = std::sqrt(dx * dx + dy * dy);
-    
+
     if (dist > 0.001f) {
         dx /= dist;
         dy /= dist;
-        
-        x += dx * moveSpeed * deltaTime * 60.0f;
-        y += dy * moveSpeed * deltaTime * 60.0f;
+
+        pool.x[i] += dx * moveSpeed * deltaTime;
+        pool.y[i] += dy * moveSpeed * deltaTime;
     }
 }
 
-void Enemy::predictPlayerMovement(float playerX, float playerY, float& predX, float& predY) {
-    // Calculate player velocity based on position change
-    float playerVelX = (playerX - lastPlayerX) / (1.0f/60.0f); // Assume 60fps
-    float playerVelY = (playerY - lastPlayerY) / (1.0f/60.0f);
-    
-    // Predict where player will be
-    predX = playerX + playerVelX * playerPredictionTime;
-    predY = playerY + playerVelY * playerPredictionTime;
-}
+void Enemy::predictPlayerMovement(const EnemyPool& pool, size_t i, float playerX, float playerY, float deltaTime, float& predX, float& predY) {
+    const EnemyBrain& brain = pool.brain[i];
 
-bool Enemy::hasLineOfSight(float targetX, float targetY) const {
-    // Simple line of sight check - in a real game you'd check for obstacles
-    // For now, just return true if within detection range
-    float dx = targetX - x;
-    float dy = targetY - y;
-    float dist = std::sqrt(dx * dx + dy * dy);
-    return dist <= detectionRange;
+    // Calculate player velocity based on position change over the last tick
+    float playerVelX = (playerX - brain.lastPlayerX) / deltaTime;
+    float playerVelY = (playerY - brain.lastPlayerY) / deltaTime;
+
+    // Predict where player will be
+    predX = playerX + playerVelX * pool.tuning[i].playerPredictionTime;
+    predY = playerY + playerVelY * pool.tuning[i].playerPredictionTime;
 }
 
-void Enemy::handleCollision(float otherX, float otherY, float otherRadius, float deltaTime) {
-    if (isColliding(otherX, otherY, otherRadius)) {
+void Enemy::handleCollision(EnemyPool& pool, size_t i, float otherX, float otherY, float otherRadius, float deltaTime) {
+    if (isColliding(pool, i, otherX, otherY, otherRadius)) {
         // Calculate push direction
-        float dx = x - otherX;
-        float dy = y - otherY;
+        float dx = pool.x[i] - otherX;
+        float dy = pool.y[i] - otherY;
         float dist = std::sqrt(dx * dx + dy * dy);
-        
+
         if (dist > 0.001f) {
             // Normalize direction
             dx /= dist;
             dy /= dist;
-            
+
             // Calculate overlap
-            float overlap = (radius + otherRadius) - dist;
-            
+            float overlap = (pool.radius[i] + otherRadius) - dist;
+
             // Push apart
-            float pushDistance = overlap * 0.5f + pushForce;
-            x += dx * pushDistance;
-            y += dy * pushDistance;
+            float pushDistance = overlap * 0.5f + pool.tuning[i].pushForce * deltaTime;
+            pool.x[i] += dx * pushDistance;
+            pool.y[i] += dy * pushDistance;
         }
     }
 }
 
-bool Enemy::isColliding(float otherX, float otherY, float otherRadius) const {
-    float dx = x - otherX;
-    float dy = y - otherY;
+bool Enemy::isColliding(const EnemyPool& pool, size_t i, float otherX, float otherY, float otherRadius) {
+    float dx = pool.x[i] - otherX;
+    float dy = pool.y[i] - otherY;
     float dist = std::sqrt(dx * dx + dy * dy);
-    return dist < (collisionRadius + otherRadius);
+    return dist < (pool.tuning[i].collisionRadius + otherRadius);
 }
 
-bool Enemy::checkMeleeHit(float targetX, float targetY, float targetRadius, int& damage) {
-    if (!canMelee) return false;
-    
-    float dx = x - targetX;
-    float dy = y - targetY;
+bool Enemy::checkMeleeHit(const EnemyPool& pool, size_t i, float targetX, float targetY, float targetRadius, int& damage) {
+    if (!pool.brain[i].canMelee) return false;
+
+    float dx = pool.x[i] - targetX;
+    float dy = pool.y[i] - targetY;
     float dist = std::sqrt(dx * dx + dy * dy);
-    
-    if (dist <= meleeRange + targetRadius) {
-        damage = meleeDamage;
+
+    if (dist <= pool.tuning[i].meleeRange + targetRadius) {
+        damage = pool.tuning[i].meleeDamage;
         return true;
     }
     return false;
 }
 
-void Enemy::updateWanderTarget() {
+void Enemy::updateWanderTarget(EnemyPool& pool, size_t i) {
+    EnemyBrain& brain = pool.brain[i];
+    float wanderRadius = pool.tuning[i].wanderRadius;
+
     // Pick a random point within wanderRadius of home position
-    float angle = randomFloatRange(0, 2 * 3.14159f);
-    float distance = randomFloatRange(wanderRadius * 0.3f, wanderRadius);
-    
-    targetX = homeX + std::cos(angle) * distance;
-    targetY = homeY + std::sin(angle) * distance;
+    float angle = brain.rng.range(0, 2 * 3.14159f);
+    float distance = brain.rng.range(wanderRadius * 0.3f, wanderRadius);
+
+    brain.targetX = brain.homeX + std::cos(angle) * distance;
+    brain.targetY = brain.homeY + std::sin(angle) * distance;
 }
 
-void Enemy::takeDamage(int amount) {
-    if (isDead) return;
-    
+void Enemy::takeDamage(EnemyPool& pool, size_t i, int amount) {
+    if (pool.isDead(i)) return;
+
     if (amount > 0) {
-        currentHealth -= amount;
-        if (currentHealth <= 0) {
-            currentHealth = 0;
-            isDead = true;
+        pool.health[i] -= amount;
+        if (pool.health[i] <= 0) {
+            pool.health[i] = 0;
         }
     }
 }
 
-float Enemy::getHealthPercentage() const {
-    return static_cast<float>(currentHealth) / maxHealth;
-}
+void Enemy::shoot(const EnemyPool& pool, size_t i, float playerX, float playerY, EnemyDeferred& deferred) {
+    float x = pool.x[i];
+    float y = pool.y[i];
 
-void Enemy::shoot(float playerX, float playerY) {
-    // Create an arrow pointing at the predicted player position
-    Arrow arrow;
-    arrow.x = x;
-    arrow.y = y;
-    
-    // Calculate direction to target
+    // Calculate direction to the predicted player position
     float dx = playerX - x;
     float dy = playerY - y;
     float dist = std::sqrt(dx * dx + dy * dy);
-    
+
     // Normalize and set velocity
     if (dist > 0) {
         dx /= dist;
         dy /= dist;
     }
-    
-    // Improved arrow speed and accuracy
-    float arrowSpeed = 0.015f;
-    arrow.vx = arrowSpeed * dx;
-    arrow.vy = arrowSpeed * dy;
-    
-    arrow.radius = radius * 0.15f;
-    arrow.active = true;
-    
-    arrows.push_back(arrow);
-}
 
-void Enemy::updateArrows(float deltaTime) {
-    // Keep track of which arrows to remove
-    std::vector<size_t> arrowsToRemove;
-    
-    // Update all arrows
-    for (size_t i = 0; i < arrows.size(); i++) {
-        auto& arrow = arrows[i];
-        if (arrow.active) {
-            // Move arrow
-            arrow.x += arrow.vx * deltaTime * 60.0f;
-            arrow.y += arrow.vy * deltaTime * 60.0f;
-            
-            // Check if arrow is out of bounds
-            if (arrow.x < -3.0f || arrow.x > 3.0f || arrow.y < -2.0f || arrow.y > 2.0f) {
-                arrow.active = false;
-                arrowsToRemove.push_back(i);
-            }
-        } else {
-            arrowsToRemove.push_back(i);
-        }
-    }
-    
-    // Remove inactive arrows
-    for (int i = arrowsToRemove.size() - 1; i >= 0; i--) {
-        size_t index = arrowsToRemove[i];
-        if (index < arrows.size()) {
-            arrows.erase(arrows.begin() + index);
-        }
-    }
-    
-    // Cap maximum arrows
-    if (arrows.size() > 8) {
-        arrows.erase(arrows.begin(), arrows.begin() + (arrows.size() - 8));
-    }
-}
+    // Improved arrow speed and accuracy
+    float arrowSpeed = 0.9f; // World units per second
 
-bool Enemy::checkArrowHit(float targetX, float targetY, float targetRadius, int& damage) {
-    // Check each arrow against the target
-    for (auto& arrow : arrows) {
-        if (arrow.active) {
-            float dx = arrow.x - targetX;
-            float dy = arrow.y - targetY;
-            float dist = std::sqrt(dx * dx + dy * dy);
-            
-            // Check collision
-            if (dist < arrow.radius + targetRadius) {
-                arrow.active = false;
-                damage = 8; // Increased arrow damage
-                return true;
-            }
-        }
-    }
-    return false;
+    // The projectile pool is shared; the arrow is spawned in applyDeferred
+    EnemyDeferred::Shot& shot = deferred.shot[i];
+    shot.x = x;
+    shot.y = y;
+    shot.vx = arrowSpeed * dx;
+    shot.vy = arrowSpeed * dy;
+    shot.radius = pool.radius[i] * 0.15f;
+    deferred.hasShot[i] = 1;
 }
@@ -2,89 +2,131 @@
 #define ENEMY_H
 
 #include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Random.h"
 
-struct Arrow {
-    float x, y;
-    float vx, vy;
-    float radius;
-    bool active;
-};
+class EnemyPool;
+class ProjectilePool;
+struct EnemyPerception;
+class JobSystem;
 
-class Enemy {
-public:
-    float x, y;
-    float radius;
-    float speed;
+// Per-enemy tuning values: read by the AI every tick but never written
+// after spawn, so they are kept out of the hot arrays.
+struct EnemyTuning {
+    float speed;               // Movement speed in world units per second
     int maxHealth;
-    int currentHealth;
-    bool isDead;
-    
+
     // Enhanced AI behavior
     float detectionRange;      // Range to detect and start following player
     float shootingRange;       // Range to start shooting at player
     float meleeRange;          // Range for melee attacks
     float wanderRadius;        // Radius within which enemy wanders
-    float homeX, homeY;        // Home position for wandering
-    
+
     // Smart movement and collision
-    float lastPlayerX, lastPlayerY;  // Track player's last known position
     float playerPredictionTime;      // How far ahead to predict player movement
     float collisionRadius;           // Radius for collision detection
-    float pushForce;                 // Force applied during collisions
-    
+    float pushForce;                 // Extra separation per second applied during collisions
+
+    // Combat
+    float meleeCooldown;
+    int meleeDamage;
+    int arrowDamage;
+    float wanderInterval;
+    float shootingCooldown;
+
+    EnemyTuning(float rad, float spd);
+};
+
+// Per-enemy AI bookkeeping: timers, targets and the enemy's random stream.
+struct EnemyBrain {
+    float homeX, homeY;              // Home position for wandering
+    float lastPlayerX, lastPlayerY;  // Track player's last known position
+
     // Enhanced combat
     float meleeTimer;
-    float meleeCooldown;
     bool canMelee;
-    int meleeDamage;
-    
+
     // Wandering behavior
     float wanderTimer;
-    float wanderInterval;
     float targetX, targetY;
-    
+
     // Shooting behavior
     float shootingTimer;
-    float shootingCooldown;
     bool canShoot;
-    std::vector<Arrow> arrows;
-    
+
+    float stateTimer;
+    uint32_t lastSwordSwing;         // Sword::swingId of the last swing that hit (0 = none)
+
+    // Own random stream, so enemies can be updated on any thread in any order
+    Rng rng;
+
+    EnemyBrain(float startX, float startY, uint64_t rngSeed);
+};
+
+// Writes to shared state requested by enemies during a parallel update,
+// one slot per enemy. Enemy::applyDeferred applies them in index order, so
+// the outcome is the same for any number of threads.
+struct EnemyDeferred {
+    struct Shot {
+        float x, y;
+        float vx, vy;
+        float radius;
+    };
+
+    std::vector<Shot> shot;                       // Arrow to spawn, valid where hasShot is set
+    std::vector<unsigned char> hasShot;
+
+    // Size for count enemies and clear all requests
+    void reset(size_t count);
+};
+
+// Enemy behavior. Enemy data lives in an EnemyPool (structure of arrays);
+// each function operates on the enemy stored at dense index i.
+class Enemy {
+public:
     // AI states
-    enum AIState {
+    enum AIState : unsigned char {
         WANDERING,
         DETECTING,
         FOLLOWING,
         ATTACKING,
         FLEEING
     };
-    AIState currentState;
-    float stateTimer;
 
-    Enemy(float startX, float startY, float rad, float spd);
-    void update(float playerX, float playerY, float deltaTime);
-    void takeDamage(int amount);
-    float getHealthPercentage() const;
-    void shoot(float playerX, float playerY);
-    void updateArrows(float deltaTime);
-    bool checkArrowHit(float targetX, float targetY, float targetRadius, int& damage);
-    bool checkMeleeHit(float targetX, float targetY, float targetRadius, int& damage);
-    
+    // Enemies per parallel-for chunk in updateAll
+    static const size_t UPDATE_BATCH_SIZE = 256;
+
+    // Advance every living enemy by one tick: batch perception picks each
+    // enemy's state, then each behavior runs over its bucket of enemies on
+    // the job system. Deferred writes are applied at the end.
+    static void updateAll(EnemyPool& pool, EnemyPerception& perception, EnemyDeferred& deferred, JobSystem& jobs,
+                          float playerX, float playerY, float deltaTime, ProjectilePool& projectiles);
+    static void applyDeferred(EnemyPool& pool, const EnemyDeferred& deferred, ProjectilePool& projectiles);
+    static void takeDamage(EnemyPool& pool, size_t i, int amount);
+    static void shoot(const EnemyPool& pool, size_t i, float playerX, float playerY, EnemyDeferred& deferred);
+    static bool checkMeleeHit(const EnemyPool& pool, size_t i, float targetX, float targetY, float targetRadius, int& damage);
+
     // Enhanced collision system
-    void handleCollision(float otherX, float otherY, float otherRadius, float deltaTime);
-    bool isColliding(float otherX, float otherY, float otherRadius) const;
-    
+    static void handleCollision(EnemyPool& pool, size_t i, float otherX, float otherY, float otherRadius, float deltaTime);
+    static bool isColliding(const EnemyPool& pool, size_t i, float otherX, float otherY, float otherRadius);
+
+    // Pick a random wander point around the enemy's home position
+    static void updateWanderTarget(EnemyPool& pool, size_t i);
+
 private:
-    void wander(float deltaTime);
-    void followPlayer(float playerX, float playerY, float deltaTime);
-    void attackPlayer(float playerX, float playerY, float deltaTime);
-    void fleeFromPlayer(float playerX, float playerY, float deltaTime);
-    void updateWanderTarget();
-    void updateAIState(float playerX, float playerY, float distToPlayer);
-    
+    static void wander(EnemyPool& pool, size_t i, float deltaTime);
+    static void followPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float deltaTime);
+    // distSq is the squared distance to the player from the perception pass
+    static void attackPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float distSq, float deltaTime,
+                             EnemyDeferred& deferred);
+    static void fleeFromPlayer(EnemyPool& pool, size_t i, float playerX, float playerY, float distSq, float deltaTime);
+    static void updateTimers(EnemyPool& pool, size_t i, float deltaTime);
+    static void enterState(EnemyPool& pool, size_t i, AIState newState);
+
     // Smart movement functions
-    void moveTowards(float targetX, float targetY, float moveSpeed, float deltaTime);
-    void predictPlayerMovement(float playerX, float playerY, float& predX, float& predY);
-    bool hasLineOfSight(float targetX, float targetY) const;
+    static void moveTowards(EnemyPool& pool, size_t i, float targetX, float targetY, float moveSpeed, float deltaTime);
+    static void predictPlayerMovement(const EnemyPool& pool, size_t i, float playerX, float playerY, float deltaTime, float& predX, float& predY);
 };
 
 #endif
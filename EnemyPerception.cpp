@@ -0,0 +1,165 @@
+#include "EnemyPerception.h"
+#include "EnemyPool.h"
+#include <cstring>
+
+#if defined(KNIGHTED_FORCE_SCALAR)
+// Plain C++ only
+#elif defined(__AVX__)
+#define PERCEPTION_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PERCEPTION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// State selection, lowest priority first; each rule overrides the ones
+// before it:
+//   within detection range            -> FOLLOWING
+//   within shooting or melee range    -> ATTACKING
+//   below flee health and closer than
+//   shooting range                    -> FLEEING
+// Line of sight is currently the detection range test itself, so the
+// DETECTING state is never selected here.
+static void perceiveScalar(const EnemyPool& pool, float playerX, float playerY,
+                           size_t begin, size_t end, EnemyPerception& out) {
+    for (size_t i = begin; i < end; i++) {
+        float dx = playerX - pool.x[i];
+        float dy = playerY - pool.y[i];
+        float d2 = dx * dx + dy * dy;
+
+        bool following = d2 <= pool.detectionRangeSq[i];
+        bool attacking = (d2 <= pool.shootingRangeSq[i]) | (d2 <= pool.meleeRangeSq[i]);
+        bool fleeing = (d2 < pool.shootingRangeSq[i]) & (static_cast<float>(pool.health[i]) < pool.fleeHealth[i]);
+
+        int state = Enemy::WANDERING;
+        state = following ? Enemy::FOLLOWING : state;
+        state = attacking ? Enemy::ATTACKING : state;
+        state = fleeing ? Enemy::FLEEING : state;
+
+        out.distSq[i] = d2;
+        out.nextState[i] = static_cast<unsigned char>(state);
+    }
+}
+
+#if defined(PERCEPTION_AVX)
+
+static size_t perceiveWide(const EnemyPool& pool, float playerX, float playerY, EnemyPerception& out) {
+    const size_t count = pool.size();
+    const size_t wideEnd = count & ~static_cast<size_t>(7);
+
+    const __m256 px = _mm256_set1_ps(playerX);
+    const __m256 py = _mm256_set1_ps(playerY);
+    const __m256 wandering = _mm256_set1_ps(static_cast<float>(Enemy::WANDERING));
+    const __m256 following = _mm256_set1_ps(static_cast<float>(Enemy::FOLLOWING));
+    const __m256 attacking = _mm256_set1_ps(static_cast<float>(Enemy::ATTACKING));
+    const __m256 fleeing = _mm256_set1_ps(static_cast<float>(Enemy::FLEEING));
+
+    for (size_t i = 0; i < wideEnd; i += 8) {
+        __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(&pool.x[i]));
+        __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(&pool.y[i]));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        _mm256_storeu_ps(&out.distSq[i], d2);
+
+        __m256 shoot2 = _mm256_loadu_ps(&pool.shootingRangeSq[i]);
+        __m256 health = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pool.health[i])));
+
+        __m256 followMask = _mm256_cmp_ps(d2, _mm256_loadu_ps(&pool.detectionRangeSq[i]), _CMP_LE_OQ);
+        __m256 attackMask = _mm256_or_ps(_mm256_cmp_ps(d2, shoot2, _CMP_LE_OQ),
+                                         _mm256_cmp_ps(d2, _mm256_loadu_ps(&pool.meleeRangeSq[i]), _CMP_LE_OQ));
+        __m256 fleeMask = _mm256_and_ps(_mm256_cmp_ps(d2, shoot2, _CMP_LT_OQ),
+                                        _mm256_cmp_ps(health, _mm256_loadu_ps(&pool.fleeHealth[i]), _CMP_LT_OQ));
+
+        __m256 state = wandering;
+        state = _mm256_blendv_ps(state, following, followMask);
+        state = _mm256_blendv_ps(state, attacking, attackMask);
+        state = _mm256_blendv_ps(state, fleeing, fleeMask);
+
+        // Narrow the eight states to bytes
+        __m256i state32 = _mm256_cvttps_epi32(state);
+        __m128i state16 = _mm_packs_epi32(_mm256_castsi256_si128(state32), _mm256_extractf128_si256(state32, 1));
+        __m128i state8 = _mm_packus_epi16(state16, state16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&out.nextState[i]), state8);
+    }
+    return wideEnd;
+}
+
+#elif defined(PERCEPTION_SSE2)
+
+static inline __m128i selectBits(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static size_t perceiveWide(const EnemyPool& pool, float playerX, float playerY, EnemyPerception& out) {
+    const size_t count = pool.size();
+    const size_t wideEnd = count & ~static_cast<size_t>(3);
+
+    const __m128 px = _mm_set1_ps(playerX);
+    const __m128 py = _mm_set1_ps(playerY);
+    const __m128i following = _mm_set1_epi32(Enemy::FOLLOWING);
+    const __m128i attacking = _mm_set1_epi32(Enemy::ATTACKING);
+    const __m128i fleeing = _mm_set1_epi32(Enemy::FLEEING);
+
+    for (size_t i = 0; i < wideEnd; i += 4) {
+        __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(&pool.x[i]));
+        __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&pool.y[i]));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        _mm_storeu_ps(&out.distSq[i], d2);
+
+        __m128 shoot2 = _mm_loadu_ps(&pool.shootingRangeSq[i]);
+        __m128 health = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&pool.health[i])));
+
+        __m128i followMask = _mm_castps_si128(_mm_cmple_ps(d2, _mm_loadu_ps(&pool.detectionRangeSq[i])));
+        __m128i attackMask = _mm_castps_si128(_mm_or_ps(_mm_cmple_ps(d2, shoot2),
+                                                        _mm_cmple_ps(d2, _mm_loadu_ps(&pool.meleeRangeSq[i]))));
+        __m128i fleeMask = _mm_castps_si128(_mm_and_ps(_mm_cmplt_ps(d2, shoot2),
+                                                       _mm_cmplt_ps(health, _mm_loadu_ps(&pool.fleeHealth[i]))));
+
+        __m128i state = _mm_set1_epi32(Enemy::WANDERING);
+        state = selectBits(followMask, following, state);
+        state = selectBits(attackMask, attacking, state);
+        state = selectBits(fleeMask, fleeing, state);
+
+        // Narrow the four states to bytes
+        __m128i state16 = _mm_packs_epi32(state, state);
+        int packed = _mm_cvtsi128_si32(_mm_packus_epi16(state16, state16));
+        std::memcpy(&out.nextState[i], &packed, 4);
+    }
+    return wideEnd;
+}
+
+#else
+
+static size_t perceiveWide(const EnemyPool&, float, float, EnemyPerception&) {
+    return 0;
+}
+
+#endif
+
+void perceiveEnemies(const EnemyPool& pool, float playerX, float playerY, EnemyPerception& out) {
+    const size_t count = pool.size();
+    out.distSq.resize(count);
+    out.nextState.resize(count);
+
+    // Vector body, then the scalar kernel for the remainder
+    size_t done = perceiveWide(pool, playerX, playerY, out);
+    perceiveScalar(pool, playerX, playerY, done, count, out);
+
+    // Group living enemies by the state they will run this tick
+    for (int s = 0; s < EnemyPerception::STATE_COUNT; s++) {
+        out.bucket[s].clear();
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (pool.isDead(i)) continue;
+        out.bucket[out.nextState[i]].push_back(static_cast<uint32_t>(i));
+    }
+}
+
+const char* perceptionKernelName() {
+#if defined(PERCEPTION_AVX)
+    return "avx";
+#elif defined(PERCEPTION_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
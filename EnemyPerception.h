@@ -0,0 +1,30 @@
+#ifndef ENEMY_PERCEPTION_H
+#define ENEMY_PERCEPTION_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Enemy.h"
+
+class EnemyPool;
+
+// Output of the batch perception pass, reused from tick to tick.
+struct EnemyPerception {
+    static const int STATE_COUNT = Enemy::FLEEING + 1;
+
+    std::vector<float> distSq;               // Squared distance to the player, per enemy (used by attack and flee)
+    std::vector<unsigned char> nextState;    // Enemy::AIState chosen this tick, per enemy
+    std::vector<uint32_t> bucket[STATE_COUNT];  // Living enemy indices grouped by next state
+};
+
+// Batch pass over all enemies: squared distance to the player and the next
+// AI state, selected with compare masks instead of branches. Uses AVX when
+// compiled with it, otherwise SSE2 on x86, otherwise plain C++; all three
+// give the same result (define KNIGHTED_FORCE_SCALAR to force plain C++).
+// Dead enemies keep their state and are not bucketed.
+void perceiveEnemies(const EnemyPool& pool, float playerX, float playerY, EnemyPerception& out);
+
+// Name of the kernel compiled in ("avx", "sse2" or "scalar")
+const char* perceptionKernelName();
+
+#endif
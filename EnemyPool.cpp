@@ -0,0 +1,154 @@
+#include "EnemyPool.h"
+#include <utility>
+
+const size_t EnemyPool::npos;
+
+EnemyPool::EnemyPool() {
+}
+
+EnemyHandle EnemyPool::add(float startX, float startY, float rad, float spd, uint64_t rngSeed) {
+    // Reuse a free slot if there is one, otherwise grow the slot table
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(generation.size());
+        generation.push_back(0);
+        indexOfSlot.push_back(0);
+    }
+
+    uint32_t index = static_cast<uint32_t>(x.size());
+    indexOfSlot[slot] = index;
+    slotOfIndex.push_back(slot);
+
+    EnemyTuning enemyTuning(rad, spd);
+    x.push_back(startX);
+    y.push_back(startY);
+    prevX.push_back(startX);
+    prevY.push_back(startY);
+    radius.push_back(rad);
+    state.push_back(Enemy::WANDERING);
+    health.push_back(enemyTuning.maxHealth);
+    meleeRangeSq.push_back(enemyTuning.meleeRange * enemyTuning.meleeRange);
+    shootingRangeSq.push_back(enemyTuning.shootingRange * enemyTuning.shootingRange);
+    detectionRangeSq.push_back(enemyTuning.detectionRange * enemyTuning.detectionRange);
+    fleeHealth.push_back(enemyTuning.maxHealth * 0.3f);
+    tuning.push_back(enemyTuning);
+    brain.push_back(EnemyBrain(startX, startY, rngSeed));
+
+    // Initialize with a random wander target
+    Enemy::updateWanderTarget(*this, index);
+
+    EnemyHandle handle = { slot, generation[slot] };
+    return handle;
+}
+
+void EnemyPool::remove(size_t i) {
+    size_t last = x.size() - 1;
+    uint32_t removedSlot = slotOfIndex[i];
+
+    if (i != last) {
+        // Move the last enemy into the hole
+        x[i] = x[last];
+        y[i] = y[last];
+        prevX[i] = prevX[last];
+        prevY[i] = prevY[last];
+        radius[i] = radius[last];
+        state[i] = state[last];
+        health[i] = health[last];
+        meleeRangeSq[i] = meleeRangeSq[last];
+        shootingRangeSq[i] = shootingRangeSq[last];
+        detectionRangeSq[i] = detectionRangeSq[last];
+        fleeHealth[i] = fleeHealth[last];
+        tuning[i] = tuning[last];
+        brain[i] = std::move(brain[last]);
+
+        uint32_t movedSlot = slotOfIndex[last];
+        slotOfIndex[i] = movedSlot;
+        indexOfSlot[movedSlot] = static_cast<uint32_t>(i);
+    }
+
+    x.pop_back();
+    y.pop_back();
+    prevX.pop_back();
+    prevY.pop_back();
+    radius.pop_back();
+    state.pop_back();
+    health.pop_back();
+    meleeRangeSq.pop_back();
+    shootingRangeSq.pop_back();
+    detectionRangeSq.pop_back();
+    fleeHealth.pop_back();
+    tuning.pop_back();
+    brain.pop_back();
+    slotOfIndex.pop_back();
+
+    // Invalidate outstanding handles and recycle the slot
+    generation[removedSlot]++;
+    freeSlots.push_back(removedSlot);
+}
+
+void EnemyPool::clear() {
+    // Invalidate every live handle before dropping the data
+    for (uint32_t slot : slotOfIndex) {
+        generation[slot]++;
+        freeSlots.push_back(slot);
+    }
+
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    radius.clear();
+    state.clear();
+    health.clear();
+    meleeRangeSq.clear();
+    shootingRangeSq.clear();
+    detectionRangeSq.clear();
+    fleeHealth.clear();
+    tuning.clear();
+    brain.clear();
+    slotOfIndex.clear();
+}
+
+void EnemyPool::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    prevX.reserve(count);
+    prevY.reserve(count);
+    radius.reserve(count);
+    state.reserve(count);
+    health.reserve(count);
+    meleeRangeSq.reserve(count);
+    shootingRangeSq.reserve(count);
+    detectionRangeSq.reserve(count);
+    fleeHealth.reserve(count);
+    tuning.reserve(count);
+    brain.reserve(count);
+    slotOfIndex.reserve(count);
+    indexOfSlot.reserve(count);
+    generation.reserve(count);
+    freeSlots.reserve(count);
+}
+
+EnemyHandle EnemyPool::handleAt(size_t i) const {
+    uint32_t slot = slotOfIndex[i];
+    EnemyHandle handle = { slot, generation[slot] };
+    return handle;
+}
+
+bool EnemyPool::isValid(EnemyHandle handle) const {
+    return handle.slot < generation.size() && generation[handle.slot] == handle.generation;
+}
+
+size_t EnemyPool::indexOf(EnemyHandle handle) const {
+    if (!isValid(handle)) {
+        return npos;
+    }
+    return indexOfSlot[handle.slot];
+}
+
+float EnemyPool::getHealthPercentage(size_t i) const {
+    return static_cast<float>(health[i]) / tuning[i].maxHealth;
+}
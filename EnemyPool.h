@@ -0,0 +1,74 @@
+#ifndef ENEMY_POOL_H
+#define ENEMY_POOL_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Enemy.h"
+
+// Stable reference to an enemy. Dense indices change when other enemies are
+// removed; a handle keeps pointing at the same enemy until it is removed,
+// after which the generation no longer matches and the handle is stale.
+struct EnemyHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// Structure-of-arrays storage for all live enemies.
+//
+// Live enemies occupy dense indices [0, size()). The fields the per-tick
+// loops touch (position, radius, state, health) sit in their own contiguous
+// arrays; tuning and AI bookkeeping are kept in separate cold arrays.
+// Removal swaps the last enemy into the hole, so it is O(1) and keeps the
+// arrays packed.
+class EnemyPool {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    EnemyPool();
+
+    // Spawn an enemy whose AI draws from the given random seed and return
+    // a handle to it
+    EnemyHandle add(float startX, float startY, float rad, float spd, uint64_t rngSeed);
+
+    // Remove the enemy at dense index i (swap-and-pop). The enemy that was
+    // last moves to index i; its handle stays valid.
+    void remove(size_t i);
+
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    // Handle lookup
+    EnemyHandle handleAt(size_t i) const;
+    bool isValid(EnemyHandle handle) const;
+    size_t indexOf(EnemyHandle handle) const;  // Dense index, or npos if stale
+
+    bool isDead(size_t i) const { return health[i] <= 0; }
+    float getHealthPercentage(size_t i) const;
+
+    // Hot data, one entry per live enemy
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY;   // Position at the start of the current tick
+    std::vector<float> radius;
+    std::vector<unsigned char> state;  // Enemy::AIState
+    std::vector<int> health;
+
+    // Perception thresholds copied out of tuning at spawn, so the batch
+    // perception pass can load them as plain float arrays
+    std::vector<float> meleeRangeSq, shootingRangeSq, detectionRangeSq;
+    std::vector<float> fleeHealth;     // Enemy flees below this health
+
+    // Cold data
+    std::vector<EnemyTuning> tuning;
+    std::vector<EnemyBrain> brain;
+
+private:
+    std::vector<uint32_t> slotOfIndex;  // Dense index -> slot
+    std::vector<uint32_t> indexOfSlot;  // Slot -> dense index
+    std::vector<uint32_t> generation;   // Per slot, bumped on removal
+    std::vector<uint32_t> freeSlots;    // Slots available for reuse
+};
+
+#endif
@@ -1,9 +1,13 @@
 #include "Font.h"
+#include "StreamArena.h"
 #include "dependente/glm/gtc/matrix_transform.hpp"
 #include "dependente/glm/gtc/type_ptr.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 // Force recompile - 1
 
@@ -17,13 +21,77 @@
 #include "dependente/stb-master/stb_image.h"
 #endif
 
-Font::Font() : VAO(0), VBO(0), shader(0) {
+// Empty texels kept around every glyph in the atlas so linear filtering
+// never picks up a neighbour (or the previous glyph of a reused cell)
+static const int ATLAS_PADDING = 1;
+static const int PAGE_SIZE = 512;
+
+// Distance field parameters: fields are rasterized at SDF_PIXEL_HEIGHT
+// with SDF_PADDING texels of falloff around each glyph, and the edge sits
+// at 128 (0.5 in the shader)
+static const float SDF_PIXEL_HEIGHT = 32.0f;
+static const int SDF_PADDING = 6;
+static const unsigned char SDF_ON_EDGE = 128;
+static const float SDF_DIST_SCALE = 128.0f / SDF_PADDING;
+
+static const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Decode the UTF-8 sequence starting at text[i] and move i past it.
+// Malformed input decodes to U+FFFD instead of stopping the string.
+static uint32_t nextCodepoint(const std::string& text, size_t& i) {
+    unsigned char lead = static_cast<unsigned char>(text[i++]);
+    if (lead < 0x80) {
+        return lead;
+    }
+    
+    int extra;
+    uint32_t codepoint, minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1; codepoint = lead & 0x1F; minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2; codepoint = lead & 0x0F; minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3; codepoint = lead & 0x07; minimum = 0x10000;
+    } else {
+        return REPLACEMENT_CHARACTER;  // Stray continuation or invalid lead byte
+    }
+    
+    for (int k = 0; k < extra; k++) {
+        if (i >= text.size() || (static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) {
+            return REPLACEMENT_CHARACTER;  // Truncated sequence
+        }
+        codepoint = (codepoint << 6) | (static_cast<unsigned char>(text[i]) & 0x3F);
+        i++;
+    }
+    
+    // Overlong forms, surrogates and values past Unicode are invalid
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return REPLACEMENT_CHARACTER;
+    }
+    return codepoint;
+}
+
+TextEffects::TextEffects()
+    : outlineColor(0.0f), outlineWidth(0.0f), glowColor(0.0f), glowWidth(0.0f) {
+}
+
+Font::Font()
+    : fontInfo(nullptr), rasterScale(0.0f),
+      atlasTexture(0), mode(FONT_BITMAP), glyphScale(1.0f),
+      pageSize(PAGE_SIZE), pageCount(0), cellSize(0), lruHead(-1), lruTail(-1),
+      frame(0), atlasGeneration(0), cacheFullReported(false),
+      VAO(0), VBO(0), vboCapacity(0), streamArena(nullptr),
+      shader(0), textColorLocation(-1), textOffsetLocation(-1),
+      outlineColorLocation(-1), outlineWidthLocation(-1), glowColorLocation(-1), glowWidthLocation(-1) {
+    for (int c = 0; c < ASCII_COUNT; c++) {
+        asciiGlyphs[c] = nullptr;
+    }
 }
 
 Font::~Font() {
-    // Clean up textures
-    for (auto& ch : Characters) {
-        glDeleteTextures(1, &ch.second.TextureID);
+    // Clean up the atlas
+    if (atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
     }
     
     // Clean up buffers
@@ -33,15 +101,11 @@ Font::~Font() {
     if (VBO) {
         glDeleteBuffers(1, &VBO);
     }
+    
+    delete fontInfo;
 }
 
-bool Font::init(const char* fontPath, int fontSize) {
-    // Clear existing character data if any
-    for (auto& ch : Characters) {
-        glDeleteTextures(1, &ch.second.TextureID);
-    }
-    Characters.clear();
-
+bool Font::init(const char* fontPath, int fontSize, FontMode fontMode, size_t cacheBytes) {
     // Read font file
     std::ifstream file(fontPath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
@@ -59,77 +123,61 @@ bool Font::init(const char* fontPath, int fontSize) {
         return false;
     }
     
-    // Initialize stb_truetype
+    // Initialize stb_truetype; the font data is kept for rasterizing later
     stbtt_fontinfo font;
     if (!stbtt_InitFont(&font, fontBuffer.data(), 0)) {
         std::cerr << "Failed to initialize stb_truetype" << std::endl;
         return false;
     }
+    fontData.swap(fontBuffer);   // Moves the storage, so font.data stays valid
+    if (!fontInfo) {
+        fontInfo = new stbtt_fontinfo;
+    }
+    *fontInfo = font;
     
-    // Calculate font scaling factor
-    float scale = stbtt_ScaleForPixelHeight(&font, static_cast<float>(fontSize));
+    // Calculate font scaling factor. Distance fields are rasterized small
+    // and scaled up by glyphScale when drawn.
+    mode = fontMode;
+    float rasterHeight = (mode == FONT_SDF) ? SDF_PIXEL_HEIGHT : static_cast<float>(fontSize);
+    rasterScale = stbtt_ScaleForPixelHeight(fontInfo, rasterHeight);
+    glyphScale = fontSize / rasterHeight;
     
-    // Store OpenGL state
-    GLint alignment;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
+    // Cells are sized for the largest glyph in the font
+    int x0, y0, x1, y1;
+    stbtt_GetFontBoundingBox(fontInfo, &x0, &y0, &x1, &y1);
+    int extent = static_cast<int>(std::ceil(std::max(x1 - x0, y1 - y0) * rasterScale));
+    if (mode == FONT_SDF) {
+        extent += 2 * SDF_PADDING;
+    }
+    cellSize = std::min(extent + 2 * ATLAS_PADDING, pageSize);
     
-    // Load first 128 ASCII characters
-    for (unsigned char c = 32; c < 128; c++) {
-        // Get glyph bitmap and metrics
-        int width, height, xoff, yoff;
-        unsigned char* bitmap = stbtt_GetCodepointBitmap(
-            &font, 0, scale, c, &width, &height, &xoff, &yoff
-        );
-        
-        if (!bitmap) {
-            std::cerr << "Failed to get bitmap for character: " << c << std::endl;
-            continue;
-        }
-        
-        // Create texture for character
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            width, height,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            bitmap
-        );
-        
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        // Get character metrics
-        int advance, lsb, x0, y0, x1, y1;
-        stbtt_GetCodepointHMetrics(&font, c, &advance, &lsb);
-        stbtt_GetCodepointBitmapBox(&font, c, scale, scale, &x0, &y0, &x1, &y1);
-        
-        // Store character data - follow LearnOpenGL exactly
-        Character character = {
-            texture,
-            glm::ivec2(width, height),
-            glm::ivec2(xoff, -yoff), // xoff for horizontal bearing, adjust yoff for OpenGL coords
-            static_cast<unsigned int>(advance) // Store the UNSCALED advance value
-        };
-        
-        Characters.insert(std::pair<char, Character>(c, character));
-        
-        // Free the bitmap
-        stbtt_FreeBitmap(bitmap, nullptr);
+    // As many pages as the budget allows (at least one)
+    GLint maxLayers = 256;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    size_t pageBytes = static_cast<size_t>(pageSize) * pageSize;
+    pageCount = static_cast<int>(std::min<size_t>(std::max<size_t>(cacheBytes / pageBytes, 1), maxLayers));
+    resetCache();
+    
+    // The atlas: one single-channel layer per page
+    if (atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
     }
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, pageSize, pageSize, pageCount, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
     
-    // Restore OpenGL state
-    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // Set texture options
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    
+    // Warm the cache with printable ASCII so the first frames do not
+    // rasterize; everything else is rasterized when first drawn
+    for (uint32_t c = 32; c < 127; c++) {
+        glyph(c);
+    }
     
     // Configure VAO/VBO for text quads
     if (VAO == 0) {
@@ -137,91 +185,407 @@ bool Font::init(const char* fontPath, int fontSize) {
         glGenBuffers(1, &VBO);
     }
     
-    glBindVertexArray(VAO);
+    // Room for a line of text; renderText grows it for longer strings
+    vboCapacity = 64;
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // Reserve memory - we'll be updating with new data when rendering each character
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vboCapacity * 6 * VERTEX_FLOATS * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    setupVertexArray(VAO, VBO);
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    std::cout << "Glyph cache: " << pageCount << " page(s) of " << (pageSize / cellSize) * (pageSize / cellSize)
+              << " cells (" << cellSize << " px)" << std::endl;
+    return true;
+}
+
+void Font::resetCache() {
+    glyphs.clear();
+    for (int c = 0; c < ASCII_COUNT; c++) {
+        asciiGlyphs[c] = nullptr;
+    }
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Lay the cells out row by row on every page
+    int cellsPerRow = pageSize / cellSize;
+    cells.clear();
+    freeCells.clear();
+    for (int page = 0; page < pageCount; page++) {
+        for (int row = 0; row < cellsPerRow; row++) {
+            for (int column = 0; column < cellsPerRow; column++) {
+                AtlasCell cell;
+                cell.codepoint = 0;
+                cell.page = page;
+                cell.x = column * cellSize;
+                cell.y = row * cellSize;
+                cell.prev = -1;
+                cell.next = -1;
+                cell.lastFrame = 0;
+                cells.push_back(cell);
+            }
+        }
+    }
+    // Hand out cells in order, starting with the first
+    for (int i = static_cast<int>(cells.size()) - 1; i >= 0; i--) {
+        freeCells.push_back(i);
+    }
+    lruHead = -1;
+    lruTail = -1;
     
-    return !Characters.empty();
+    uploadData.clear();
+    pendingUploads.clear();
+    cacheFullReported = false;
+    atlasGeneration++;
 }
 
-void Font::setShader(GLuint shaderProgram) {
-    shader = shaderProgram;
+void Font::unlinkCell(int cell) {
+    AtlasCell& c = cells[cell];
+    if (c.prev >= 0) {
+        cells[c.prev].next = c.next;
+    } else if (lruHead == cell) {
+        lruHead = c.next;
+    }
+    if (c.next >= 0) {
+        cells[c.next].prev = c.prev;
+    } else if (lruTail == cell) {
+        lruTail = c.prev;
+    }
+    c.prev = -1;
+    c.next = -1;
 }
 
-void Font::renderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
-    if (!shader || Characters.empty()) {
+void Font::touchCell(int cell) {
+    cells[cell].lastFrame = frame;
+    if (lruHead == cell) {
         return;
     }
     
-    // Enable blending for text rendering
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Move to the front of the LRU list
+    unlinkCell(cell);
+    cells[cell].next = lruHead;
+    if (lruHead >= 0) {
+        cells[lruHead].prev = cell;
+    }
+    lruHead = cell;
+    if (lruTail < 0) {
+        lruTail = cell;
+    }
+}
+
+int Font::allocateCell() {
+    if (!freeCells.empty()) {
+        int cell = freeCells.back();
+        freeCells.pop_back();
+        return cell;
+    }
     
-    // Activate corresponding render state
-    glUseProgram(shader);
-    glUniform3f(glGetUniformLocation(shader, "textColor"), color.x, color.y, color.z);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
+    // Evict the least recently used glyph, unless even that one is
+    // on screen this frame
+    int victim = lruTail;
+    if (victim < 0 || cells[victim].lastFrame == frame) {
+        return -1;
+    }
+    uint32_t evicted = cells[victim].codepoint;
+    if (evicted < ASCII_COUNT) {
+        asciiGlyphs[evicted] = nullptr;
+    }
+    glyphs.erase(evicted);
+    unlinkCell(victim);
+    atlasGeneration++;
+    return victim;
+}
+
+bool Font::rasterize(uint32_t codepoint, Character& character) {
+    // Missing characters use glyph 0, the font's "missing glyph" box
+    int glyphIndex = stbtt_FindGlyphIndex(fontInfo, static_cast<int>(codepoint));
+    
+    // Get glyph bitmap and metrics
+    int width = 0, height = 0, xoff = 0, yoff = 0;
+    unsigned char* bitmap = nullptr;
+    if (mode == FONT_SDF) {
+        bitmap = stbtt_GetGlyphSDF(fontInfo, rasterScale, glyphIndex, SDF_PADDING, SDF_ON_EDGE, SDF_DIST_SCALE,
+                                   &width, &height, &xoff, &yoff);
+    } else {
+        bitmap = stbtt_GetGlyphBitmap(fontInfo, 0, rasterScale, glyphIndex, &width, &height, &xoff, &yoff);
+    }
+    
+    int advance, lsb;
+    stbtt_GetGlyphHMetrics(fontInfo, glyphIndex, &advance, &lsb);
+    
+    // Store character data - follow LearnOpenGL exactly
+    character.UV = glm::vec4(0.0f);
+    character.Size = glm::ivec2(0, 0);
+    character.Bearing = glm::ivec2(xoff, -yoff); // xoff for horizontal bearing, adjust yoff for OpenGL coords
+    character.Advance = static_cast<unsigned int>(advance); // Store the UNSCALED advance value
+    character.Cell = -1;
+    
+    // Whitespace has no bitmap but still advances the pen
+    if (!bitmap) {
+        return true;
+    }
+    
+    int cell = allocateCell();
+    if (cell < 0) {
+        stbtt_FreeBitmap(bitmap, nullptr);
+        if (!cacheFullReported) {
+            std::cerr << "Glyph cache full with glyphs drawn this frame; skipping glyphs" << std::endl;
+            cacheFullReported = true;
+        }
+        return false;
+    }
+    
+    // Glyphs bigger than a cell (rare, the cell fits the font's bounding box) are clipped
+    int usable = cellSize - 2 * ATLAS_PADDING;
+    int stride = width;
+    width = std::min(width, usable);
+    height = std::min(height, usable);
+    
+    // Stage the glyph with an empty border for the next upload
+    AtlasCell& slot = cells[cell];
+    slot.codepoint = codepoint;
+    PendingUpload upload;
+    upload.page = slot.page;
+    upload.x = slot.x;
+    upload.y = slot.y;
+    upload.width = width + 2 * ATLAS_PADDING;
+    upload.height = height + 2 * ATLAS_PADDING;
+    upload.offset = uploadData.size();
+    uploadData.resize(upload.offset + static_cast<size_t>(upload.width) * upload.height, 0);
+    for (int row = 0; row < height; row++) {
+        std::copy(bitmap + static_cast<size_t>(row) * stride,
+                  bitmap + static_cast<size_t>(row) * stride + width,
+                  uploadData.begin() + (upload.offset + static_cast<size_t>(row + ATLAS_PADDING) * upload.width + ATLAS_PADDING));
+    }
+    pendingUploads.push_back(upload);
+    stbtt_FreeBitmap(bitmap, nullptr);
+    
+    int gx = slot.x + ATLAS_PADDING;
+    int gy = slot.y + ATLAS_PADDING;
+    float inv = 1.0f / pageSize;
+    character.UV = glm::vec4(gx * inv, gy * inv, (gx + width) * inv, (gy + height) * inv);
+    character.Size = glm::ivec2(width, height);
+    character.Cell = cell;
+    touchCell(cell);
+    return true;
+}
+
+const Character* Font::glyph(uint32_t codepoint) {
+    Character* found = nullptr;
+    if (codepoint < ASCII_COUNT) {
+        found = asciiGlyphs[codepoint];
+    } else {
+        std::unordered_map<uint32_t, Character>::iterator it = glyphs.find(codepoint);
+        if (it != glyphs.end()) {
+            found = &it->second;
+        }
+    }
+    if (found) {
+        if (found->Cell >= 0) {
+            touchCell(found->Cell);
+        }
+        return found;
+    }
     
-    // Iterate through all characters
+    // First use: rasterize into the cache
+    Character character;
+    if (!fontInfo || !rasterize(codepoint, character)) {
+        return nullptr;
+    }
+    Character& stored = glyphs[codepoint];
+    stored = character;
+    if (codepoint < ASCII_COUNT) {
+        asciiGlyphs[codepoint] = &stored;
+    }
+    return &stored;
+}
+
+void Font::flushUploads() {
+    if (pendingUploads.empty()) {
+        return;
+    }
+    
+    // Store OpenGL state
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
+    
+    // Every glyph staged since the last flush, in order, so a reused
+    // cell ends up with its newest glyph
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+    for (const PendingUpload& upload : pendingUploads) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, upload.x, upload.y, upload.page,
+                        upload.width, upload.height, 1, GL_RED, GL_UNSIGNED_BYTE,
+                        uploadData.data() + upload.offset);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    
+    // Restore OpenGL state
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    
+    pendingUploads.clear();
+    uploadData.clear();
+}
+
+void Font::setupVertexArray(GLuint vao, GLuint vbo, GLintptr offset) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    
+    // Position and texture coordinates, then the atlas page
+    GLsizei stride = VERTEX_FLOATS * sizeof(float);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 4 * sizeof(float)));
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Font::setStreamArena(StreamArena* arena) {
+    streamArena = arena;
+    if (!streamArena && VAO) {
+        setupVertexArray(VAO, VBO);
+    }
+}
+
+void Font::setShader(GLuint shaderProgram) {
+    shader = shaderProgram;
+    textColorLocation = glGetUniformLocation(shader, "textColor");
+    textOffsetLocation = glGetUniformLocation(shader, "textOffset");
+    outlineColorLocation = glGetUniformLocation(shader, "outlineColor");
+    outlineWidthLocation = glGetUniformLocation(shader, "outlineWidth");
+    glowColorLocation = glGetUniformLocation(shader, "glowColor");
+    glowWidthLocation = glGetUniformLocation(shader, "glowWidth");
+}
+
+float Font::measureText(const std::string& text, float scale) {
+    float width = 0.0f;
+    for (size_t i = 0; i < text.size();) {
+        const Character* ch = glyph(nextCodepoint(text, i));
+        if (ch) {
+            width += (ch->Advance * scale) / 64.0f;
+        }
+    }
+    return width;
+}
+
+float Font::buildQuads(const std::string& text, float x, float y, float scale, std::vector<float>& out) {
     float x_pos = x;
-    for (char c : text) {
-        if (Characters.find(c) == Characters.end()) {
+    for (size_t i = 0; i < text.size();) {
+        const Character* found = glyph(nextCodepoint(text, i));
+        if (!found) {
             continue;
         }
-        
-        Character ch = Characters[c];
-        
-        // Pre-calculate scaled values
-        float scaled_bearing_x = ch.Bearing.x * scale;
+    
+        const Character& ch = *found;
+    
+        // Pre-calculate scaled values (glyph texels are glyphScale pixels)
+        float texelScale = scale * glyphScale;
+        float scaled_bearing_x = ch.Bearing.x * texelScale;
         // More precise advance: Scale first, then divide by 64.0f
-        float scaled_advance = (ch.Advance * scale) / 64.0f; 
-        float scaled_width = ch.Size.x * scale;
-        float scaled_height = ch.Size.y * scale;
-
+        float scaled_advance = (ch.Advance * scale) / 64.0f;
+        float scaled_width = ch.Size.x * texelScale;
+        float scaled_height = ch.Size.y * texelScale;
+    
         // Calculate positions EXACTLY as in the LearnOpenGL tutorial
         float xpos = x_pos + scaled_bearing_x; // Use pre-calculated scaled bearing
-        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-        
+        float ypos = y - (ch.Size.y - ch.Bearing.y) * texelScale;
+    
         float w = scaled_width; // Use pre-calculated scaled width
         float h = scaled_height; // Use pre-calculated scaled height
-        
-        // Update VBO for each character - match EXACTLY from tutorial
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos,     ypos,       0.0f, 1.0f },
-            
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f }
-        };
-        
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        // Render quad (only if character has dimensions)
-        if (w > 0 && h > 0) {
-             glDrawArrays(GL_TRIANGLES, 0, 6);
+    
+        // Only characters with a bitmap need a quad
+        if (ch.Cell >= 0 && w > 0 && h > 0) {
+            float u0 = ch.UV.x, v0 = ch.UV.y, u1 = ch.UV.z, v1 = ch.UV.w;
+            float page = static_cast<float>(cells[ch.Cell].page);
+            const float quad[6][VERTEX_FLOATS] = {
+                { xpos,     ypos + h,   u0, v0, page },
+                { xpos + w, ypos,       u1, v1, page },
+                { xpos,     ypos,       u0, v1, page },
+    
+                { xpos,     ypos + h,   u0, v0, page },
+                { xpos + w, ypos + h,   u1, v0, page },
+                { xpos + w, ypos,       u1, v1, page }
+            };
+            out.insert(out.end(), &quad[0][0], &quad[0][0] + 6 * VERTEX_FLOATS);
         }
-        
+    
         // Now advance cursor for next glyph
         x_pos += scaled_advance; // Use the more precise scaled advance
     }
+    return x_pos - x;
+}
+
+void Font::drawQuads(GLuint vao, GLsizei vertexCount, float x, float y, glm::vec3 color,
+                     const TextEffects& effects) {
+    if (!shader || !atlasTexture || vertexCount == 0) {
+        return;
+    }
+    
+    // Glyphs rasterized since the last draw go up in one pass
+    flushUploads();
+    
+    // Enable blending for text rendering
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // Activate corresponding render state
+    glUseProgram(shader);
+    glUniform3f(textColorLocation, color.x, color.y, color.z);
+    glUniform2f(textOffsetLocation, x, y);
+    if (mode == FONT_SDF) {
+        // Effect widths in texels -> distance field units (0.5 = glyph edge)
+        float texelDistance = 0.5f / SDF_PADDING;
+        float outlineWidth = std::min(effects.outlineWidth, static_cast<float>(SDF_PADDING));
+        float glowWidth = std::min(effects.glowWidth, static_cast<float>(SDF_PADDING));
+        glUniform3f(outlineColorLocation, effects.outlineColor.x, effects.outlineColor.y, effects.outlineColor.z);
+        glUniform1f(outlineWidthLocation, outlineWidth * texelDistance);
+        glUniform4f(glowColorLocation, effects.glowColor.x, effects.glowColor.y, effects.glowColor.z, effects.glowColor.w);
+        glUniform1f(glowWidthLocation, glowWidth * texelDistance);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+    glBindVertexArray(vao);
+    
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
     
     // Restore state
     glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-} 
\ No newline at end of file
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void Font::renderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+    if (!shader || !atlasTexture) {
+        return;
+    }
+    
+    // Build one quad per visible character
+    vertices.clear();
+    buildQuads(text, x, y, scale, vertices);
+    size_t glyphCount = vertices.size() / (6 * VERTEX_FLOATS);
+    if (glyphCount == 0) {
+        return;
+    }
+    
+    // Copy the whole string into this frame's arena space
+    if (streamArena) {
+        StreamAllocation allocation = streamArena->allocate(vertices.size() * sizeof(float),
+                                                            VERTEX_FLOATS * sizeof(float));
+        if (!allocation.data) {
+            return;
+        }
+        std::memcpy(allocation.data, vertices.data(), allocation.size);
+        streamArena->commit(allocation);
+        setupVertexArray(VAO, streamArena->buffer(), allocation.offset);
+        drawQuads(VAO, static_cast<GLsizei>(glyphCount * 6), 0.0f, 0.0f, color);
+        return;
+    }
+    
+    // Upload the whole string, growing the buffer if it does not fit
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (glyphCount > vboCapacity) {
+        vboCapacity = std::max(glyphCount, vboCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, vboCapacity * 6 * VERTEX_FLOATS * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    drawQuads(VAO, static_cast<GLsizei>(glyphCount * 6), 0.0f, 0.0f, color);
+}
@@ -1,43 +1,167 @@
 #ifndef FONT_H
 #define FONT_H
 
-#include <map>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
 #include "dependente/glew/glew.h"
 #include "dependente/glm/glm.hpp"
 
+struct stbtt_fontinfo;
+class StreamArena;
+
 // Character structure matching the LearnOpenGL tutorial
 struct Character {
-    GLuint TextureID;  // ID handle of the glyph texture
+    glm::vec4 UV;      // Atlas region: u0, v0 (top left), u1, v1 (bottom right)
     glm::ivec2 Size;   // Size of glyph
     glm::ivec2 Bearing;// Offset from baseline to left/top of glyph
     unsigned int Advance;    // Offset to advance to next glyph
+    int Cell;          // Atlas cell holding the bitmap, -1 for glyphs without one (spaces)
+};
+
+// How glyphs are stored in the atlas
+enum FontMode {
+    FONT_BITMAP,   // Coverage bitmaps rasterized at the font size
+    FONT_SDF       // Signed distance fields; sharp at any scale, needs text_sdf_fragment.glsl
 };
 
+// Outline and glow around SDF text; widths are in atlas texels (at most
+// the SDF padding). Bitmap fonts ignore them.
+struct TextEffects {
+    glm::vec3 outlineColor;
+    float outlineWidth;
+    glm::vec4 glowColor;   // Alpha is the glow strength
+    float glowWidth;
+
+    TextEffects();
+};
+
+// Text is UTF-8. Glyphs are rasterized the first time they are used and
+// kept in a glyph cache: fixed-size cells on the pages (layers) of one
+// array texture, sized by a memory budget. When every cell is taken the
+// least recently used glyph is evicted, unless it was drawn this frame.
 class Font {
 public:
     // Constructor/Destructor
     Font();
     ~Font();
 
-    // Initialize font with given font file and size
-    bool init(const char* fontPath, int fontSize);
-    
-    // Render text at the specified position with given scale and color
+    // Default glyph cache budget: four 512x512 pages
+    static const size_t DEFAULT_CACHE_BYTES = 4 * 512 * 512;
+
+    // Initialize font with given font file and size. In FONT_SDF mode the
+    // atlas is built from smaller distance fields that are scaled up to
+    // fontSize when drawn. cacheBytes bounds the atlas texture.
+    bool init(const char* fontPath, int fontSize, FontMode mode = FONT_BITMAP,
+              size_t cacheBytes = DEFAULT_CACHE_BYTES);
+
+    // Render text at the specified position with given scale and color.
+    // The whole string is one buffer upload and one draw.
     void renderText(const std::string& text, float x, float y, float scale, glm::vec3 color);
-    
+
     // Set the shader to use for rendering
     void setShader(GLuint shaderProgram);
 
+    // Stream renderText's quads through arena instead of the font's own
+    // buffer; null goes back to the own buffer
+    void setStreamArena(StreamArena* arena);
+
+    bool isLoaded() const { return atlasTexture != 0; }
+    FontMode getMode() const { return mode; }
+
+    // Call once per frame before any text is built; glyphs used in the
+    // current frame are never evicted
+    void beginFrame() { frame++; }
+
+    // Bumped whenever a glyph is evicted; quads built under an older
+    // generation may point at reused cells and must be rebuilt
+    unsigned int generation() const { return atlasGeneration; }
+
+    // Width of text in pixels at the given scale, summed from glyph advances
+    float measureText(const std::string& text, float scale);
+
+    // Append two triangles (VERTEX_FLOATS per vertex: x, y, u, v, page)
+    // for every visible glyph of text, with the baseline starting at
+    // (x, y). Returns the width.
+    float buildQuads(const std::string& text, float x, float y, float scale, std::vector<float>& out);
+    static const int VERTEX_FLOATS = 5;
+
+    // Draw vertexCount vertices built by buildQuads from vao, moved by (x, y)
+    void drawQuads(GLuint vao, GLsizei vertexCount, float x, float y, glm::vec3 color,
+                   const TextEffects& effects = TextEffects());
+
+    // Send the glyphs rasterized since the last upload to the atlas in one
+    // pass; drawQuads does this before drawing
+    void flushUploads();
+
+    // Point vao's attributes at vbo, starting offset bytes in, using the
+    // buildQuads vertex layout
+    static void setupVertexArray(GLuint vao, GLuint vbo, GLintptr offset = 0);
+
 private:
-    // Map of ASCII characters to their corresponding Character struct
-    std::map<char, Character> Characters;
-    
+    // One fixed-size slot of the atlas, linked into the LRU list while it
+    // holds a glyph
+    struct AtlasCell {
+        uint32_t codepoint;
+        int page, x, y;
+        int prev, next;            // LRU neighbours (head = most recently used)
+        unsigned long lastFrame;   // Frame the glyph was last drawn in
+    };
+
+    // A rasterized glyph waiting in uploadData for flushUploads
+    struct PendingUpload {
+        int page, x, y, width, height;
+        size_t offset;
+    };
+
+    // Glyph for codepoint, rasterized on first use; null if it could not be cached
+    const Character* glyph(uint32_t codepoint);
+    bool rasterize(uint32_t codepoint, Character& character);
+    int allocateCell();
+    void touchCell(int cell);
+    void unlinkCell(int cell);
+    void resetCache();
+
+    // Font file and stb_truetype state, kept for on-demand rasterizing
+    std::vector<unsigned char> fontData;
+    stbtt_fontinfo* fontInfo;
+    float rasterScale;               // stb_truetype scale of the atlas glyphs
+
+    // Glyph cache: ASCII goes through a flat table, everything else
+    // through the map. Map nodes are stable, so the table points into it.
+    static const int ASCII_COUNT = 128;
+    std::unordered_map<uint32_t, Character> glyphs;
+    Character* asciiGlyphs[ASCII_COUNT];
+
+    // Atlas pages and their cells
+    GLuint atlasTexture;             // GL_TEXTURE_2D_ARRAY, one layer per page
+    FontMode mode;
+    float glyphScale;                // Atlas texels -> pixels at scale 1
+    int pageSize, pageCount, cellSize;
+    std::vector<AtlasCell> cells;
+    std::vector<int> freeCells;
+    int lruHead, lruTail;
+    unsigned long frame;
+    unsigned int atlasGeneration;
+    bool cacheFullReported;
+
+    // Glyph bitmaps waiting to be uploaded
+    std::vector<unsigned char> uploadData;
+    std::vector<PendingUpload> pendingUploads;
+
     // VAO and VBO for text rendering
     GLuint VAO, VBO;
-    
-    // Shader program ID
+    size_t vboCapacity;              // Glyph quads the VBO has room for
+    StreamArena* streamArena;        // Replaces VBO for renderText when set
+    std::vector<float> vertices;     // Quads of the string being drawn
+
+    // Shader program ID and its uniform locations (looked up once)
     GLuint shader;
+    GLint textColorLocation;
+    GLint textOffsetLocation;
+    GLint outlineColorLocation, outlineWidthLocation;
+    GLint glowColorLocation, glowWidthLocation;
 };
 
-#endif 
\ No newline at end of file
+#endif
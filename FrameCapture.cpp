@@ -0,0 +1,100 @@
+#include "FrameCapture.h"
+#include <cstdlib>
+#include <iostream>
+#include "dependente/stb-master/stb_image.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "dependente/stb-master/stb_image_write.h"
+
+FrameCapture::FrameCapture() : FBO(0), colorBuffer(0), width(0), height(0) {
+}
+
+FrameCapture::~FrameCapture() {
+    if (colorBuffer) {
+        glDeleteRenderbuffers(1, &colorBuffer);
+    }
+    if (FBO) {
+        glDeleteFramebuffers(1, &FBO);
+    }
+}
+
+bool FrameCapture::init(int captureWidth, int captureHeight) {
+    width = captureWidth;
+    height = captureHeight;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Capture framebuffer incomplete (status 0x" << std::hex << status << std::dec << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void FrameCapture::bind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+}
+
+void FrameCapture::read(std::vector<unsigned char>& pixels) {
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    // Rows are tightly packed
+    GLint alignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+}
+
+bool writeFramePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels) {
+    // GL rows start at the bottom, PNG rows at the top
+    stbi_flip_vertically_on_write(1);
+    if (!stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool compareFramePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels,
+                     int tolerance, size_t& differing) {
+    differing = 0;
+    int goldenWidth, goldenHeight, channels;
+    unsigned char* golden = stbi_load(path.c_str(), &goldenWidth, &goldenHeight, &channels, 4);
+    if (!golden) {
+        std::cerr << "Failed to load golden image " << path << std::endl;
+        return false;
+    }
+    if (goldenWidth != width || goldenHeight != height) {
+        std::cerr << "Golden image " << path << " is " << goldenWidth << "x" << goldenHeight
+                  << ", frame is " << width << "x" << height << std::endl;
+        stbi_image_free(golden);
+        return false;
+    }
+
+    for (int y = 0; y < height; y++) {
+        // The golden image is stored top row first
+        const unsigned char* goldenRow = golden + static_cast<size_t>(height - 1 - y) * width * 4;
+        const unsigned char* frameRow = pixels.data() + static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < 4; c++) {
+                if (std::abs(goldenRow[x * 4 + c] - frameRow[x * 4 + c]) > tolerance) {
+                    differing++;
+                    break;
+                }
+            }
+        }
+    }
+    stbi_image_free(golden);
+    return true;
+}
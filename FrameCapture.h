@@ -0,0 +1,42 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <string>
+#include <vector>
+#include "dependente/glew/glew.h"
+
+// Offscreen render target: a framebuffer object with an RGBA8 color
+// buffer, read back into memory after each frame. Lets frames be rendered
+// and saved without a visible window (e.g. Mesa llvmpipe under Xvfb).
+class FrameCapture {
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    bool init(int width, int height);
+
+    // Make the capture buffer the render target
+    void bind();
+
+    // Wait for the frame to finish and copy it into pixels, four bytes per
+    // pixel, bottom row first
+    void read(std::vector<unsigned char>& pixels);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    GLuint FBO, colorBuffer;
+    int width, height;
+};
+
+// Save pixels as read by FrameCapture::read as a PNG (top row first)
+bool writeFramePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels);
+
+// Compare pixels against a PNG written by writeFramePng. differing is the
+// number of pixels where some channel differs by more than tolerance.
+// Returns false if the image cannot be loaded or has another size.
+bool compareFramePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels,
+                     int tolerance, size_t& differing);
+
+#endif
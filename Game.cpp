@@ -1,71 +1,53 @@
 #include "Game.h"
+#include "FrameCapture.h"
 #include "dependente/glm/gtc/matrix_transform.hpp"
 #include "dependente/glm/gtc/type_ptr.hpp"
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
 #include <cmath>
+#include <ctime>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
 #include "dependente/glfw/glfw3.h"
 
-// Utility: generate circle vertices (positions only)
-std::vector<float> createCircleVertices(float radius, int segments) {
-    std::vector<float> vertices;
-    // Center point
-    vertices.push_back(0.0f);
-    vertices.push_back(0.0f);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = 2.0f * 3.14159265358979323846f * i / segments;
-        float x = radius * cos(angle);
-        float y = radius * sin(angle);
-        vertices.push_back(x);
-        vertices.push_back(y);
-    }
-    return vertices;
+// Utility: blend an interpolated render position between two simulation ticks
+static float interpolate(float previous, float current, float alpha) {
+    return previous + (current - previous) * alpha;
 }
 
+// Profiled passes: one per render layer, then the text drawn after the queue
+static const int PASS_TEXT = RENDER_LAYER_COUNT;
+static const int PASS_COUNT = PASS_TEXT + 1;
+static const char* const passNames[PASS_COUNT] = { "terrain", "entities", "weapons", "HUD", "overlays", "text" };
+
 Game::Game()
     : window(nullptr), screenWidth(0), screenHeight(0),
-    shaderProgram(nullptr), textShader(nullptr), gameFont(nullptr),
-    circleVAO(0), circleVBO(0),
-    rectVAO(0), rectVBO(0),
-    swordVAO(0), swordVBO(0),
-    arrowVAO(0), arrowVBO(0),
-    tileVAO(0), tileVBO(0),
-    segments(50), baseRadius(0.05f),
-    enemySpeed(0.008f), maxEnemies(4), totalEnemiesSpawned(0), enemySpawnTimer(0.0f), enemySpawnInterval(4.0f),
-    arrowActive(false), mouseWasPressed(false),
-    arrowSpeed(0.02f), damageTimer(0.0f), damageCooldown(3.0f),
-    rightMouseWasPressed(false),
+    textShader(nullptr), shapeShader(nullptr), quadShader(nullptr), meshShader(nullptr), gameFont(nullptr),
+    killCounterValue(-1), winKillsValue(-1),
+    streamArena(nullptr), shapeBatch(nullptr), quadBatch(nullptr),
+    gpuProfiler(nullptr), showGpuTimes(false), gpuTimesKeyDown(false),
+    swordVAO(0), swordVBO(0), swordEBO(0), swordIndexCount(0),
+    arrowVAO(0), arrowVBO(0), arrowEBO(0), arrowIndexCount(0),
+    tileVAO(0), tileVBO(0), terrainVertexCount(0),
+    baseRadius(0.05f),
     terrainGenerated(false),
+    simulation(nullptr),
+    replaying(false), seed(0), offscreenFrames(0), offscreenEgl(false),
     deathScreenTimeout(3.0f), lastFrameTime(0.0), deltaTime(0.0f),
-    gameWon(false), winTime(0.0f), totalEnemiesKilled(0), enemiesToKill(5)
+    tickAccumulator(0.0f), maxTicksPerFrame(5), renderAlpha(1.0f), view(nullptr)
 {
-    // Initialize sword parameters - simplified
-    sword.offsetX = baseRadius * 2.5f;  // Initial position
-    sword.offsetY = 0.0f;
-    sword.angle = 0.0f;
-    sword.length = baseRadius * 3.5f;   
-    sword.width = baseRadius * 0.4f;    
-    sword.hitboxRadius = baseRadius * 1.5f; 
-    sword.isSwinging = false;
-    sword.swingSpeed = 0.05f;           // Moderate speed for visibility
-    sword.swingAngle = 3.14159f * 2.0f; // Not used in new system
-    sword.swingProgress = 0.0f;
-    sword.damage = 25;                  // Good damage
-    sword.cooldown = 1.0f;              // 1 second cooldown
-    sword.cooldownTimer = 0.0f;
-    
-    // Seed random number generator
-    srand(static_cast<unsigned int>(time(NULL)));
+    for (int p = 0; p < GpuProfiler::MAX_PASSES; p++) {
+        gpuPassShownMs[p] = -1.0f;
+    }
 }
 
 Game::~Game() {
     // Cleanup is done in cleanup()
 }
 
-float randomFloat(float min, float max) {
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
-}
-
 bool Game::init() {
     // Initialize GLFW
     if (!glfwInit()) {
@@ -79,9 +61,19 @@ bool Game::init() {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+    // Offscreen mode draws into a hidden window's context, so it needs no
+    // monitor; EGL lets Mesa's software rasterizer run without GLX
+    bool offscreen = offscreenFrames > 0;
+    if (offscreen) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        if (offscreenEgl) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        }
+    }
+
     // Create full-screen window using primary monitor's resolution
-    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
-    if (!monitor) {
+    GLFWmonitor* monitor = offscreen ? nullptr : glfwGetPrimaryMonitor();
+    if (!monitor && !offscreen) {
         std::cerr << "Failed to get primary monitor" << std::endl;
         glfwTerminate();
         return false;
@@ -114,9 +106,12 @@ bool Game::init() {
     }
     glViewport(0, 0, screenWidth, screenHeight);
 
-    // Build shader program
-    shaderProgram = new Shader("vertex_shader.glsl", "fragment_shader.glsl");
-    textShader = new Shader("text_vertex.glsl", "text_fragment.glsl");
+    // Build shader programs
+    textShader = new Shader("text_vertex.glsl", "text_sdf_fragment.glsl");  // Distance field font
+    shapeShader = new Shader("shape_vertex.glsl", "shape_fragment.glsl");
+    quadShader = new Shader("quad_vertex.glsl", "quad_fragment.glsl");
+    meshShader = new Shader("mesh_vertex.glsl", "mesh_fragment.glsl");
+    meshModelUniform = meshShader->uniform<GL_FLOAT_MAT4>("uModel");
 
     // Enable blending for transparent elements
     glEnable(GL_BLEND);
@@ -133,9 +128,9 @@ bool Game::init() {
     gameFont = new Font();
     
     // Try different font paths in order of preference
-    if (!gameFont->init("assets/fonts/arial.ttf", 48)) {
-        if (!gameFont->init("assets/fonts/medieval.ttf", 48)) {
-            if (!gameFont->init("C:/Windows/Fonts/arial.ttf", 48)) {
+    if (!gameFont->init("assets/fonts/arial.ttf", 48, FONT_SDF)) {
+        if (!gameFont->init("assets/fonts/medieval.ttf", 48, FONT_SDF)) {
+            if (!gameFont->init("C:/Windows/Fonts/arial.ttf", 48, FONT_SDF)) {
                 std::cerr << "Failed to load any font" << std::endl;
                 // Continue anyway, we'll just not render text
             }
@@ -150,10 +145,20 @@ bool Game::init() {
     else {
         std::cout << "Loaded font: assets/fonts/arial.ttf" << std::endl;
     }
+    
+    // End screen text never changes, so lay it out once
+    deathTitleText.set(gameFont, "YOU DIED!", 2.0f);
+    winTitleText.set(gameFont, "VICTORY!", 2.5f);
+    exitHintText.set(gameFont, "Press ESC to exit", 1.0f);
+
+    // Projections reach every shader through the FrameData uniform block
+    if (!frameUniforms.init()) {
+        std::cerr << "Failed to create frame uniform buffer" << std::endl;
+        return false;
+    }
 
     // Configure text shader
     textShader->use();
-    textShader->setMat4("projection", glm::value_ptr(textProjection));
     textShader->setInt("text", 0);
     
     // Set the shader for the font
@@ -161,46 +166,63 @@ bool Game::init() {
         gameFont->setShader(textShader->ID);
     }
 
-    // Generate circle vertices (player, enemy, arrow all use the same base mesh)
-    circleVertices = createCircleVertices(baseRadius, segments);
-    glGenVertexArrays(1, &circleVAO);
-    glGenBuffers(1, &circleVBO);
-    glBindVertexArray(circleVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, circleVBO);
-    glBufferData(GL_ARRAY_BUFFER, circleVertices.size() * sizeof(float), circleVertices.data(), GL_STATIC_DRAW);
-    // Our vertices are 2 floats per vertex (x, y)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
-
-    // Create the player
-    player = new Player(0.0f, 0.0f, baseRadius, 0.001f);
+    // Create the simulation; the arena matches the visible world area
+    SimulationConfig config;
+    config.arenaHalfWidth = aspect;
+    config.arenaHalfHeight = 1.0f;
+    config.baseRadius = baseRadius;
+    config.seed = seed;
+    if (config.seed == 0) {
+        // Offscreen frames must be reproducible; the game gets a new layout every launch
+        config.seed = offscreen ? 1 : static_cast<uint64_t>(time(NULL));
+    }
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            return false;
+        }
+        replay.applyTo(config);
+        replaying = true;
+        std::cout << "Replaying " << replay.getTickCount() << " ticks from " << replayPath << std::endl;
+    }
+    if (!recordPath.empty() && !recorder.open(recordPath, config)) {
+        return false;
+    }
+    simulation = new Simulation(config);
+
+    // One frame of streamed vertices: a shape for the player, its shield
+    // ring, each enemy and each projectile plus two per health bar, the
+    // overlay quads, and a few lines of dynamic text
+    size_t shapeCapacity = 2 + config.maxEnemies + config.maxProjectiles + 2 * (config.maxEnemies + 1);
+    size_t quadCapacity = 64;
+    size_t textBytes = 256 * 6 * Font::VERTEX_FLOATS * sizeof(float);
+    streamArena = new StreamArena();
+    if (!streamArena->init(shapeCapacity * ShapeBatch::SHAPE_BYTES + quadCapacity * QuadBatch::QUAD_BYTES +
+                           textBytes + 4096)) {  // Slack for alignment
+        return false;
+    }
+    if (gameFont) {
+        gameFont->setStreamArena(streamArena);
+    }
 
-    // Create initial enemies
-    spawnEnemies(2);  // Start with 2 smart enemies instead of 3
+    // Shape batcher for entities, projectiles and health bars; edges are
+    // antialiased over one pixel
+    shapeBatch = new ShapeBatch();
+    if (!shapeBatch->init(shapeShader->ID, shapeCapacity, &renderQueue, streamArena)) {
+        return false;
+    }
+    shapeBatch->setPixelSize(2.0f / screenHeight);
 
-    arrowActive = false;
-    mouseWasPressed = false;
+    // Quad batcher for the death and win overlays
+    quadBatch = new QuadBatch();
+    if (!quadBatch->init(quadShader->ID, quadCapacity, &renderQueue, streamArena)) {
+        return false;
+    }
 
-    // Generate rectangle vertices for health bar
-    std::vector<float> rectVertices = {
-        // positions (x, y)
-        0.0f, 0.0f,  // bottom left
-        1.0f, 0.0f,  // bottom right
-        1.0f, 1.0f,  // top right
-        0.0f, 0.0f,  // bottom left
-        1.0f, 1.0f,  // top right
-        0.0f, 1.0f   // top left
-    };
-    
-    glGenVertexArrays(1, &rectVAO);
-    glGenBuffers(1, &rectVBO);
-    glBindVertexArray(rectVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, rectVBO);
-    glBufferData(GL_ARRAY_BUFFER, rectVertices.size() * sizeof(float), rectVertices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+    // Timer queries for each pass
+    gpuProfiler = new GpuProfiler();
+    if (!gpuProfiler->init(PASS_COUNT)) {
+        return false;
+    }
 
     // Initialize the sword
     initSword();
@@ -215,222 +237,66 @@ void Game::processInput() {
     // Check ESC key.
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
-    // Update player input with deltaTime
-    player->update(window, deltaTime);
-
-    // Handle arrow firing on left mouse click (debounced)
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
-        if (!arrowActive && !mouseWasPressed) {
-            double mouseX, mouseY;
-            glfwGetCursorPos(window, &mouseX, &mouseY);
-            float ndcX = static_cast<float>(mouseX) / screenWidth * 2.0f - 1.0f;
-            float ndcY = 1.0f - static_cast<float>(mouseY) / screenHeight * 2.0f;
-            float aspect = static_cast<float>(screenWidth) / screenHeight;
-            float worldX = ndcX * aspect;
-            float worldY = ndcY;
-            float dirX = worldX - player->x;
-            float dirY = worldY - player->y;
-            float len = std::sqrt(dirX * dirX + dirY * dirY);
-            if (len != 0) {
-                dirX /= len;
-                dirY /= len;
-            }
-            arrow.x = player->x;
-            arrow.y = player->y;
-            arrow.vx = arrowSpeed * dirX;
-            arrow.vy = arrowSpeed * dirY;
-            arrow.radius = baseRadius * 0.2f;
-            // Calculate arrow rotation angle based on direction
-            arrow.angle = atan2(dirY, dirX) - 3.14159f / 2.0f; // Subtract 90 degrees since arrow points up by default
-            arrowActive = true;
-            mouseWasPressed = true;
-        }
-    }
-    else {
-        mouseWasPressed = false;
-    }
-    
-    // Handle sword swing on right mouse click - SIMPLIFIED
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
-        if (!sword.isSwinging && sword.cooldownTimer <= 0 && !rightMouseWasPressed && !player->isDead) {
-            // Start sword attack - simple and reliable
-            sword.isSwinging = true;
-            sword.swingProgress = 0.0f;
-            rightMouseWasPressed = true;
-            
-            std::cout << "Starting sword attack!" << std::endl;
-        }
-    }
-    else {
-        rightMouseWasPressed = false;
-    }
-}
 
-void Game::spawnEnemies(int count) {
+    // Movement
+    input.moveUp = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input.moveDown = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.moveLeft = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.moveRight = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+
+    // Mouse buttons and aim (converted from window pixels to world space)
+    input.fireArrow = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    input.swingSword = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+    float ndcX = static_cast<float>(mouseX) / screenWidth * 2.0f - 1.0f;
+    float ndcY = 1.0f - static_cast<float>(mouseY) / screenHeight * 2.0f;
     float aspect = static_cast<float>(screenWidth) / screenHeight;
-    
-    for (int i = 0; i < count; i++) {
-        // Only spawn if we have less than the maximum number of enemies AND
-        // haven't spawned the total number needed for the game
-        if (enemies.size() < maxEnemies && totalEnemiesSpawned < enemiesToKill) {
-            // Spawn enemies at random positions around the player
-            float angle = randomFloat(0, 2 * 3.14159f);
-            float distance = randomFloat(1.0f, 1.8f);  // Spawn farther away from the player
-            
-            float spawnX = player->x + std::cos(angle) * distance;
-            float spawnY = player->y + std::sin(angle) * distance;
-            
-            // Clamp to screen boundaries
-            if (spawnX < -aspect + baseRadius) spawnX = -aspect + baseRadius;
-            if (spawnX > aspect - baseRadius) spawnX = aspect - baseRadius;
-            if (spawnY < -1.0f + baseRadius) spawnY = -1.0f + baseRadius;
-            if (spawnY > 1.0f - baseRadius) spawnY = 1.0f - baseRadius;
-            
-            // Add new enemy
-            enemies.push_back(Enemy(spawnX, spawnY, baseRadius, enemySpeed));
-            totalEnemiesSpawned++;
-            std::cout << "Spawned enemy " << totalEnemiesSpawned << "/" << enemiesToKill << std::endl;
-        }
-    }
-}
-
-void Game::update() {
-    processInput();
-
-    // For testing purposes, damage player every few seconds (T key)
-    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) {
-        damageTimer += deltaTime;
-        if (damageTimer >= damageCooldown) {
-            player->takeDamage(10);
-            damageTimer = 0.0f;
-        }
-    }
-    
-    // For testing purposes, heal player (H key)
-    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
-        player->heal(5);
-    }
-    
-    // For testing purposes, kill player instantly (K key)
-    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS && !player->isDead) {
-        player->takeDamage(player->currentHealth);
-    }
-
-    // Update sword
-    updateSword();
-
-    // Check win condition
-    checkWinCondition();
-
-    // Spawn enemies periodically
-    if (enemies.size() < maxEnemies && totalEnemiesSpawned < enemiesToKill) {
-        enemySpawnTimer += deltaTime;
-        if (enemySpawnTimer >= enemySpawnInterval) {
-            spawnEnemies(1);  // Spawn one enemy at a time
-            enemySpawnTimer = 0.0f;
-        }
-    }
-
-    // Update arrows
-    if (arrowActive) {
-        arrow.x += arrow.vx * deltaTime * 60.0f;
-        arrow.y += arrow.vy * deltaTime * 60.0f;
-        
-        // Continuously update arrow angle based on current velocity direction
-        if (arrow.vx != 0.0f || arrow.vy != 0.0f) {
-            arrow.angle = atan2(arrow.vy, arrow.vx) - 3.14159f / 2.0f;
-        }
-        
-        float aspect = static_cast<float>(screenWidth) / screenHeight;
-        if (arrow.x < -aspect + arrow.radius || arrow.x > aspect - arrow.radius ||
-            arrow.y < -1.0f + arrow.radius || arrow.y > 1.0f - arrow.radius)
-            arrowActive = false;
-            
-        // Check collision with enemies
-        for (auto& enemy : enemies) {
-            if (!enemy.isDead) {
-                float dx = arrow.x - enemy.x;
-                float dy = arrow.y - enemy.y;
-                float d = std::sqrt(dx * dx + dy * dy);
-                if (d < arrow.radius + enemy.radius) {
-                    enemy.takeDamage(10); // Arrow does 10 damage
-                    arrowActive = false;
-                    break;
-                }
-            }
-        }
-    }
+    input.aimX = ndcX * aspect;
+    input.aimY = ndcY;
 
-    // Update enemies and check for enemy arrow hits on player
-    for (auto& enemy : enemies) {
-        // Update enemy with deltaTime
-        enemy.update(player->x, player->y, deltaTime);
-        
-        // Handle collision with player (both directions)
-        if (!player->isDead && !enemy.isDead) {
-            enemy.handleCollision(player->x, player->y, player->radius, deltaTime);
-            player->handleCollision(enemy.x, enemy.y, enemy.radius, deltaTime);
-            
-            // Check for melee attacks on player
-            if (!player->isInvulnerable) {
-                int meleeDamage = 0;
-                if (enemy.checkMeleeHit(player->x, player->y, player->radius, meleeDamage)) {
-                    player->takeDamage(meleeDamage);
-                }
-            }
-        }
-        
-        // Check if any enemy arrows hit the player
-        if (!player->isDead && !player->isInvulnerable) {
-            int damage = 0;
-            if (enemy.checkArrowHit(player->x, player->y, player->radius, damage)) {
-                player->takeDamage(damage);
-            }
-        }
-    }
+    // Debug keys
+    input.debugDamage = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+    input.debugHeal = glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS;
+    input.debugKill = glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS;
 
-    // Remove dead enemies and count kills
-    auto it = enemies.begin();
-    while (it != enemies.end()) {
-        if (it->isDead) {
-            totalEnemiesKilled++;
-            std::cout << "Enemy killed! Total kills: " << totalEnemiesKilled << "/" << enemiesToKill << std::endl;
-            it = enemies.erase(it);
-        } else {
-            ++it;
-        }
+    // F3 toggles the GPU pass times on the press, not while held
+    bool gpuTimesKey = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (gpuTimesKey && !gpuTimesKeyDown) {
+        showGpuTimes = !showGpuTimes;
     }
+    gpuTimesKeyDown = gpuTimesKey;
+}
 
-    // Handle enemy-to-enemy collisions
-    for (size_t i = 0; i < enemies.size(); i++) {
-        for (size_t j = i + 1; j < enemies.size(); j++) {
-            if (!enemies[i].isDead && !enemies[j].isDead) {
-                enemies[i].handleCollision(enemies[j].x, enemies[j].y, enemies[j].radius, deltaTime);
-                enemies[j].handleCollision(enemies[i].x, enemies[i].y, enemies[i].radius, deltaTime);
-            }
+int Game::update() {
+    // Consume the frame time in fixed simulation ticks
+    float tickDuration = simulation->getTickDuration();
+    tickAccumulator += deltaTime;
+
+    int ticks = 0;
+    while (tickAccumulator >= tickDuration && ticks < maxTicksPerFrame) {
+        InputState tickInput = input;
+        if (replaying && !replay.next(tickInput)) {
+            // Recording exhausted; continue with live input
+            replaying = false;
+            tickInput = input;
+            std::cout << "Replay finished, live input resumed" << std::endl;
         }
+        recorder.record(tickInput);
+        simulation->step(tickInput);
+        tickAccumulator -= tickDuration;
+        ticks++;
     }
 
-    // Boundary clamping for player
-    float aspect = static_cast<float>(screenWidth) / screenHeight;
-    if (player->x < -aspect + player->radius) player->x = -aspect + player->radius;
-    if (player->x > aspect - player->radius) player->x = aspect - player->radius;
-    if (player->y < -1.0f + player->radius) player->y = -1.0f + player->radius;
-    if (player->y > 1.0f - player->radius) player->y = 1.0f - player->radius;
-    
-    // Boundary clamping for enemies
-    for (auto& enemy : enemies) {
-        if (enemy.x < -aspect + enemy.radius) enemy.x = -aspect + enemy.radius;
-        if (enemy.x > aspect - enemy.radius) enemy.x = aspect - enemy.radius;
-        if (enemy.y < -1.0f + enemy.radius) enemy.y = -1.0f + enemy.radius;
-        if (enemy.y > 1.0f - enemy.radius) enemy.y = 1.0f - enemy.radius;
+    // After a long hitch, drop the time we could not catch up on instead of
+    // carrying it into the next frames
+    if (tickAccumulator >= tickDuration) {
+        tickAccumulator = std::fmod(tickAccumulator, tickDuration);
     }
+    return ticks;
 }
 
 void Game::renderHealthBar() {
-    // Bind the rectangle VAO
-    glBindVertexArray(rectVAO);
-    
     // Set up health bar position and size (top left)
     float aspect = static_cast<float>(screenWidth) / screenHeight;
     float barWidth = 0.3f;
@@ -438,246 +304,242 @@ void Game::renderHealthBar() {
     float barPosX = -aspect + 0.05f; // 0.05f padding from left edge
     float barPosY = 1.0f - barHeight - 0.05f; // 0.05f padding from top edge
     
-    // Draw health bar background (dark red)
-    shaderProgram->setVec4("uColor", 0.4f, 0.1f, 0.1f, 1.0f);
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(barPosX, barPosY, 0.0f));
-    model = glm::scale(model, glm::vec3(barWidth, barHeight, 1.0f));
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    // Draw health bar fill (bright red) - scale based on current health
-    float healthPercentage = player->getHealthPercentage();
-    if (healthPercentage > 0.0f) { // Only render if there's health remaining
-        shaderProgram->setVec4("uColor", 0.9f, 0.2f, 0.2f, 1.0f);
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(barPosX, barPosY, 0.0f));
-        model = glm::scale(model, glm::vec3(barWidth * healthPercentage, barHeight, 1.0f));
-        shaderProgram->setMat4("uModel", glm::value_ptr(model));
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    // Background (dark red), then the fill (bright red) as long as the current health
+    float healthPercentage = view->player.getHealthPercentage();
+    float cornerRadius = barHeight * 0.5f;
+    shapeBatch->setLayer(RENDER_HUD);
+    shapeBatch->addRoundedBar(barPosX, barPosY, barWidth, barHeight, cornerRadius, glm::vec4(0.4f, 0.1f, 0.1f, 1.0f));
+    if (healthPercentage > 0.0f) {
+        shapeBatch->addRoundedBar(barPosX, barPosY, barWidth * healthPercentage, barHeight, cornerRadius,
+                                  glm::vec4(0.9f, 0.2f, 0.2f, 1.0f));
     }
-    
-    glBindVertexArray(0);
 }
 
-void Game::renderEnemyHealthBar(const Enemy& enemy) {
-    if (enemy.isDead) return; // Don't render health bar for dead enemies
-    
-    // Bind the rectangle VAO
-    glBindVertexArray(rectVAO);
-    
+void Game::renderEnemyHealthBar(const RenderSnapshot::Enemy& enemy, float enemyX, float enemyY) {
     // Set up health bar position and size (above the enemy)
     float barWidth = 0.1f;  // Smaller than player's health bar
     float barHeight = 0.02f;
-    float barPosX = enemy.x - barWidth / 2.0f; // Center bar above enemy
-    float barPosY = enemy.y + enemy.radius + 0.02f; // Position above enemy with small gap
-    
-    // Draw health bar background (dark red)
-    shaderProgram->setVec4("uColor", 0.4f, 0.1f, 0.1f, 1.0f);
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(barPosX, barPosY, 0.0f));
-    model = glm::scale(model, glm::vec3(barWidth, barHeight, 1.0f));
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    // Draw remaining health (bright red) - scale based on current health
-    float healthPercentage = enemy.getHealthPercentage();
-    if (healthPercentage > 0.0f) { // Only render if there's health remaining
-        shaderProgram->setVec4("uColor", 0.9f, 0.2f, 0.2f, 1.0f);
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(barPosX, barPosY, 0.0f));
-        model = glm::scale(model, glm::vec3(barWidth * healthPercentage, barHeight, 1.0f));
-        shaderProgram->setMat4("uModel", glm::value_ptr(model));
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    float barPosX = enemyX - barWidth / 2.0f; // Center bar above enemy
+    float barPosY = enemyY + enemy.radius + 0.02f; // Position above enemy with small gap
+    
+    // Background (dark red), then the fill (bright red) as long as the current health
+    float healthPercentage = enemy.health;
+    float cornerRadius = barHeight * 0.5f;
+    shapeBatch->setLayer(RENDER_HUD);
+    shapeBatch->addRoundedBar(barPosX, barPosY, barWidth, barHeight, cornerRadius, glm::vec4(0.4f, 0.1f, 0.1f, 1.0f));
+    if (healthPercentage > 0.0f) {
+        shapeBatch->addRoundedBar(barPosX, barPosY, barWidth * healthPercentage, barHeight, cornerRadius,
+                                  glm::vec4(0.9f, 0.2f, 0.2f, 1.0f));
     }
-    
-    glBindVertexArray(0);
+}
+
+bool Game::isDeathScreenVisible() const {
+    // Shown once the player has been dead longer than the timeout
+    const Player& player = view->player;
+    return player.isDead && view->time - player.timeOfDeath >= deathScreenTimeout;
 }
 
 void Game::renderDeathScreen() {
-    // Calculate how long the player has been dead
-    float timeSinceDeath = static_cast<float>(glfwGetTime()) - player->timeOfDeath;
-    
-    // If player has been dead longer than timeout, show death screen
-    if (timeSinceDeath >= deathScreenTimeout) {
-        // Bind the rectangle VAO
-        glBindVertexArray(rectVAO);
-        
-        // Fill the screen with dark overlay
-        float aspect = static_cast<float>(screenWidth) / screenHeight;
-        shaderProgram->setVec4("uColor", 0.0f, 0.0f, 0.0f, 0.7f); // Semi-transparent black
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(-aspect, -1.0f, 0.0f)); // Bottom-left corner
-        model = glm::scale(model, glm::vec3(2.0f * aspect, 2.0f, 1.0f)); // Scale to fill screen
-        shaderProgram->setMat4("uModel", glm::value_ptr(model));
-        
-        // Enable blending for transparent overlay
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        
-        // Render text with proper font rendering
-        if (gameFont) {
-            // Center "YOU DIED!" text on screen
-            const std::string deathMessage = "YOU DIED!";
-            float textScale = 2.0f;
-            
-            // In LearnOpenGL tutorial, text coordinates are from the baseline
-            // Calculate width of text (approximate)
-            float textWidth = deathMessage.length() * 20.0f * textScale;
-            
-            // Position text in center of screen
-            float textX = (screenWidth - textWidth) / 2.0f;
-            float textY = screenHeight / 2.0f;
-            
-            // Draw "YOU DIED!" text - red color
-            gameFont->renderText(deathMessage, textX, textY, textScale, glm::vec3(0.8f, 0.0f, 0.0f));
-            
-            // Draw instruction text below
-            const std::string exitMessage = "Press ESC to exit";
-            float instructionScale = 1.0f;
-            
-            // Position instruction text below main message
-            float instructionWidth = exitMessage.length() * 10.0f * instructionScale;
-            float instructionX = (screenWidth - instructionWidth) / 2.0f;
-            float instructionY = textY - 50.0f;
-            
-            gameFont->renderText(exitMessage, instructionX, instructionY, instructionScale, glm::vec3(1.0f, 1.0f, 1.0f));
-        }
-        
-        // Disable blending
-        glDisable(GL_BLEND);
-        
-        glBindVertexArray(0);
-    }
+    // Fill the screen with a semi-transparent black overlay
+    float aspect = static_cast<float>(screenWidth) / screenHeight;
+    quadBatch->setLayer(RENDER_OVERLAY);
+    quadBatch->addQuad(-aspect, -1.0f, 2.0f * aspect, 2.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.7f));
 }
 
-void Game::render() {
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Black background
-    glClear(GL_COLOR_BUFFER_BIT);
-    shaderProgram->use();
-    shaderProgram->setMat4("uProjection", glm::value_ptr(projection));
+void Game::renderDeathText() {
+    // Render text with proper font rendering
+    if (gameFont) {
+        // Center "YOU DIED!" text on screen (text coordinates are from the baseline)
+        float textX = (screenWidth - deathTitleText.width()) / 2.0f;
+        float textY = screenHeight / 2.0f;
+        
+        // Draw "YOU DIED!" text - red with a dark outline and red glow
+        TextEffects titleEffects;
+        titleEffects.outlineColor = glm::vec3(0.1f, 0.0f, 0.0f);
+        titleEffects.outlineWidth = 1.5f;
+        titleEffects.glowColor = glm::vec4(1.0f, 0.1f, 0.0f, 0.6f);
+        titleEffects.glowWidth = 4.0f;
+        deathTitleText.draw(textX, textY, glm::vec3(0.8f, 0.0f, 0.0f), titleEffects);
+        
+        // Draw instruction text below main message
+        float instructionX = (screenWidth - exitHintText.width()) / 2.0f;
+        float instructionY = textY - 50.0f;
+        exitHintText.draw(instructionX, instructionY, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
+}
 
-    // Render background tiles first
-    renderTerrain();
+void Game::renderCircles() {
+    const Player& player = view->player;
+    shapeBatch->setLayer(RENDER_ENTITIES);
 
-    // Set up for player rendering
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(player->x, player->y, 0.0f));
-    model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    shaderProgram->setVec2("uOffset", 0.0f, 0.0f); // Reset offset
-    shaderProgram->setFloat("uScale", 1.0f);
-    
-    // Draw player
-    if (player->isDead) {
+    // Player
+    glm::vec4 color(0.0f, 0.0f, 0.0f, 1.0f);
+    if (player.isDead) {
         // Dead player (red)
-        shaderProgram->setVec4("uColor", 0.7f, 0.0f, 0.0f, 1.0f); // Red
-    } else if (player->isInvulnerable) {
+        color.r = 0.7f; color.g = 0.0f; color.b = 0.0f;
+    } else if (player.isInvulnerable &&
+               static_cast<int>(player.invulnerabilityTimer * 10) % 2 == 0) {
         // Flash the player white during invulnerability
-        int flashInterval = static_cast<int>(player->invulnerabilityTimer * 10) % 2;
-        if (flashInterval == 0) {
-            shaderProgram->setVec4("uColor", 1.0f, 1.0f, 1.0f, 1.0f); // White
-        } else {
-            shaderProgram->setVec4("uColor", 0.2f, 0.7f, 0.3f, 1.0f); // Green
-        }
+        color.r = 1.0f; color.g = 1.0f; color.b = 1.0f;
     } else {
         // Normal player (green)
-        shaderProgram->setVec4("uColor", 0.2f, 0.7f, 0.3f, 1.0f);
+        color.r = 0.2f; color.g = 0.7f; color.b = 0.3f;
     }
-    
-    glBindVertexArray(circleVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2);
-    glBindVertexArray(0);
-    
-    // Render the sword
+    float playerX = interpolate(player.prevX, player.x, renderAlpha);
+    float playerY = interpolate(player.prevY, player.y, renderAlpha);
+    shapeBatch->addCircle(playerX, playerY, baseRadius, color);
+
+    // Shield ring around the player while hits are ignored
+    if (player.isInvulnerable && !player.isDead) {
+        shapeBatch->addRing(playerX, playerY, baseRadius * 1.4f, baseRadius * 0.15f,
+                            glm::vec4(0.5f, 0.8f, 1.0f, 0.8f));
+    }
+
+    // Enemies, colored by AI state
+    for (size_t i = 0; i < view->enemies.size(); i++) {
+        const RenderSnapshot::Enemy& enemy = view->enemies[i];
+        switch (enemy.state) {
+            case Enemy::WANDERING:
+                color.r = 0.6f; color.g = 0.4f; color.b = 0.4f; // Dark red (idle)
+                break;
+            case Enemy::DETECTING:
+                color.r = 0.9f; color.g = 0.6f; color.b = 0.2f; // Orange (searching)
+                break;
+            case Enemy::FOLLOWING:
+                color.r = 0.8f; color.g = 0.3f; color.b = 0.3f; // Red (following)
+                break;
+            case Enemy::ATTACKING:
+                color.r = 1.0f; color.g = 0.2f; color.b = 0.2f; // Bright red (attacking)
+                break;
+            case Enemy::FLEEING:
+                color.r = 0.7f; color.g = 0.2f; color.b = 0.8f; // Purple (fleeing)
+                break;
+            default:
+                color.r = 0.8f; color.g = 0.2f; color.b = 0.2f; // Default red
+                break;
+        }
+        shapeBatch->addCircle(interpolate(enemy.prevX, enemy.x, renderAlpha),
+                              interpolate(enemy.prevY, enemy.y, renderAlpha), enemy.radius, color);
+    }
+
+    // Enemy arrows (orange), short capsules along their direction of travel
+    color.r = 0.8f; color.g = 0.6f; color.b = 0.0f;
+    for (size_t p = 0; p < view->projectiles.size(); p++) {
+        const RenderSnapshot::Projectile& projectile = view->projectiles[p];
+        if (projectile.faction != FACTION_ENEMY) continue;
+        float x = interpolate(projectile.prevX, projectile.x, renderAlpha);
+        float y = interpolate(projectile.prevY, projectile.y, renderAlpha);
+        float radius = projectile.radius;
+        float speed = std::sqrt(projectile.vx * projectile.vx + projectile.vy * projectile.vy);
+        float dirX = 1.0f, dirY = 0.0f;
+        if (speed > 0.0f) {
+            dirX = projectile.vx / speed;
+            dirY = projectile.vy / speed;
+        }
+        float halfLength = radius * 0.5f;
+        shapeBatch->addCapsule(x - dirX * halfLength, y - dirY * halfLength,
+                               x + dirX * halfLength, y + dirY * halfLength, radius * 0.6f, color);
+    }
+}
+
+void Game::queueMesh(GLuint vao, GLsizei indexCount, const glm::mat4& model) {
+    DrawCommand& command = renderQueue.add(RENDER_WEAPONS, meshShader->ID, vao, 0);
+    command.indexed = true;
+    command.count = indexCount;
+    command.setModel(meshModelUniform.location, glm::value_ptr(model));
+}
+
+void Game::render() {
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Black background
+    glClear(GL_COLOR_BUFFER_BIT);
+    const Player& player = view->player;
+
+    // Text rendering last frame changed GL state behind the cache's back
+    glState.invalidate();
+    gpuProfiler->beginFrame();
+    streamArena->beginFrame();
+    if (gameFont) {
+        gameFont->beginFrame();
+    }
+    frameUniforms.update(glm::value_ptr(projection), glm::value_ptr(textProjection),
+                         static_cast<float>(view->time));
+    shapeBatch->begin();
+    quadBatch->begin();
+
+    // Queue everything except text; the queue orders it by layer
+    renderTerrain();
+    renderCircles();
     renderSword();
 
-    // Render player arrow with proper arrow shape
-    renderArrow();
-
-    // Draw all enemies and their arrows
-    for (const auto& enemy : enemies) {
-        if (!enemy.isDead) {
-            // Set enemy color based on AI state
-            switch (enemy.currentState) {
-                case Enemy::WANDERING:
-                    shaderProgram->setVec4("uColor", 0.6f, 0.4f, 0.4f, 1.0f); // Dark red (idle)
-                    break;
-                case Enemy::DETECTING:
-                    shaderProgram->setVec4("uColor", 0.9f, 0.6f, 0.2f, 1.0f); // Orange (searching)
-                    break;
-                case Enemy::FOLLOWING:
-                    shaderProgram->setVec4("uColor", 0.8f, 0.3f, 0.3f, 1.0f); // Red (following)
-                    break;
-                case Enemy::ATTACKING:
-                    shaderProgram->setVec4("uColor", 1.0f, 0.2f, 0.2f, 1.0f); // Bright red (attacking)
-                    break;
-                case Enemy::FLEEING:
-                    shaderProgram->setVec4("uColor", 0.7f, 0.2f, 0.8f, 1.0f); // Purple (fleeing)
-                    break;
-                default:
-                    shaderProgram->setVec4("uColor", 0.8f, 0.2f, 0.2f, 1.0f); // Default red
-                    break;
-            }
-            
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(enemy.x, enemy.y, 0.0f));
-            model = glm::scale(model, glm::vec3(enemy.radius / baseRadius, enemy.radius / baseRadius, 1.0f));
-            shaderProgram->setMat4("uModel", glm::value_ptr(model));
-            glBindVertexArray(circleVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2);
-            glBindVertexArray(0);
-            
-            // Draw enemy health bar
-            renderEnemyHealthBar(enemy);
-            
-            // Draw enemy arrows
-            for (const auto& arrow : enemy.arrows) {
-                if (arrow.active) {
-                    shaderProgram->setVec4("uColor", 0.8f, 0.6f, 0.0f, 1.0f); // Orange for enemy arrows
-                    model = glm::mat4(1.0f);
-                    model = glm::translate(model, glm::vec3(arrow.x, arrow.y, 0.0f));
-                    model = glm::scale(model, glm::vec3(arrow.radius / baseRadius, arrow.radius / baseRadius, 1.0f));
-                    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-                    glBindVertexArray(circleVAO);
-                    glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2);
-                    glBindVertexArray(0);
-                }
+    // Render player arrows with proper arrow shape
+    if (!player.isDead) {
+        for (size_t p = 0; p < view->projectiles.size(); p++) {
+            if (view->projectiles[p].faction == FACTION_PLAYER) {
+                renderArrow(view->projectiles[p]);
             }
         }
     }
 
-    // Reset for health bar and death screen
-    model = glm::mat4(1.0f);
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    shaderProgram->setVec2("uOffset", 0.0f, 0.0f);
-    shaderProgram->setFloat("uScale", 1.0f);
+    // Enemy health bars over the enemies
+    for (size_t i = 0; i < view->enemies.size(); i++) {
+        const RenderSnapshot::Enemy& enemy = view->enemies[i];
+        float enemyX = interpolate(enemy.prevX, enemy.x, renderAlpha);
+        float enemyY = interpolate(enemy.prevY, enemy.y, renderAlpha);
+        renderEnemyHealthBar(enemy, enemyX, enemyY);
+    }
 
     // Draw health bar (only if player is alive)
-    if (!player->isDead) {
+    if (!player.isDead) {
         renderHealthBar();
     }
     
-    // Draw death screen if player is dead
-    if (player->isDead) {
+    // Overlays for the death and win screens
+    bool deathScreen = isDeathScreenVisible();
+    if (deathScreen) {
         renderDeathScreen();
     }
-    
-    // Draw win screen if game is won
-    if (gameWon) {
+    if (view->gameWon) {
         renderWinScreen();
     }
+    bool gpuTimes = showGpuTimes;
+    if (gpuTimes) {
+        renderGpuTimes();
+    }
+    shapeBatch->flush();
+    quadBatch->flush();
+
+    renderQueue.submit(glState, gpuProfiler);
 
-    // Render kill counter
+    // Text goes over everything the queue drew
+    gpuProfiler->beginPass(PASS_TEXT);
+    if (deathScreen) {
+        renderDeathText();
+    }
+    if (view->gameWon) {
+        renderWinText();
+    }
     renderKillCounter();
+    if (gpuTimes) {
+        renderGpuTimesText();
+    }
+    gpuProfiler->endPass();
 
-    glfwSwapBuffers(window);
+    // Nothing of this frame may be overwritten until the GPU has drawn it
+    streamArena->endFrame();
 }
 
 void Game::cleanup() {
+    recorder.close();
+
+    killCounterText.release();
+    deathTitleText.release();
+    winTitleText.release();
+    winKillsText.release();
+    exitHintText.release();
+    for (int p = 0; p < GpuProfiler::MAX_PASSES; p++) {
+        gpuPassText[p].release();
+    }
+    frameUniforms.release();
     if (gameFont) {
         delete gameFont;
         gameFont = nullptr;
@@ -688,24 +550,52 @@ void Game::cleanup() {
         textShader = nullptr;
     }
     
-    if (shaderProgram) {
-        delete shaderProgram;
-        shaderProgram = nullptr;
+    if (shapeShader) {
+        delete shapeShader;
+        shapeShader = nullptr;
+    }
+    
+    if (shapeBatch) {
+        delete shapeBatch;
+        shapeBatch = nullptr;
+    }
+    
+    if (quadBatch) {
+        delete quadBatch;
+        quadBatch = nullptr;
     }
     
-    if (player) {
-        delete player;
-        player = nullptr;
+    if (streamArena) {
+        delete streamArena;
+        streamArena = nullptr;
+    }
+    
+    if (gpuProfiler) {
+        delete gpuProfiler;
+        gpuProfiler = nullptr;
+    }
+    
+    if (quadShader) {
+        delete quadShader;
+        quadShader = nullptr;
+    }
+    
+    if (meshShader) {
+        delete meshShader;
+        meshShader = nullptr;
+    }
+    
+    if (simulation) {
+        delete simulation;
+        simulation = nullptr;
     }
     
-    glDeleteVertexArrays(1, &circleVAO);
-    glDeleteBuffers(1, &circleVBO);
-    glDeleteVertexArrays(1, &rectVAO);
-    glDeleteBuffers(1, &rectVBO);
     glDeleteVertexArrays(1, &swordVAO);
     glDeleteBuffers(1, &swordVBO);
+    glDeleteBuffers(1, &swordEBO);
     glDeleteVertexArrays(1, &arrowVAO);
     glDeleteBuffers(1, &arrowVBO);
+    glDeleteBuffers(1, &arrowEBO);
     glDeleteVertexArrays(1, &tileVAO);
     glDeleteBuffers(1, &tileVBO);
     glfwDestroyWindow(window);
@@ -714,729 +604,391 @@ void Game::cleanup() {
 
 void Game::run() {
     lastFrameTime = glfwGetTime();
+    publishSnapshot();
+    
+    // The render thread owns the GL context from here on
+    glfwMakeContextCurrent(nullptr);
+    renderThread = std::thread(&Game::renderLoop, this);
     
     while (!glfwWindowShouldClose(window)) {
+        // Sleep until input arrives or the next tick is due
+        float untilNextTick = simulation->getTickDuration() - tickAccumulator;
+        if (untilNextTick > 0.0f) {
+            glfwWaitEventsTimeout(untilNextTick);
+        } else {
+            glfwPollEvents();
+        }
+        
         // Calculate delta time
         double currentTime = glfwGetTime();
         deltaTime = static_cast<float>(currentTime - lastFrameTime);
         lastFrameTime = currentTime;
         
         processInput();
-        update();
-        render();
-        glfwPollEvents();
+        if (update() > 0) {
+            publishSnapshot();
+        }
     }
+    
+    snapshots.stop();
+    renderThread.join();
+    glfwMakeContextCurrent(window);
 }
 
-void Game::initSword() {
-    // Create vertices for a 2D sword shape
-    // The sword will be composed of multiple geometric shapes (handle, guard, blade)
-    swordVertices.clear();
-    
-    // Define sword relative to origin (0,0)
-    float bladeLength = sword.length * 0.75f;  // 75% of total length is the blade
-    float handleLength = sword.length * 0.25f; // 25% of total length is the handle
-    float bladeWidth = sword.width;
-    float handleWidth = sword.width * 0.5f;
-    float guardWidth = sword.width * 3.0f;     // Wider guard for more medieval look
-    float guardHeight = sword.width * 0.6f;
-    
-    // Blade vertices with a more tapered look (pointed at the end)
-    swordVertices.push_back(0.0f);                     // Blade tip x
-    swordVertices.push_back(bladeLength);              // Blade tip y
-    
-    swordVertices.push_back(-bladeWidth/2.0f);         // Blade left edge x
-    swordVertices.push_back(guardHeight/2.0f);         // Blade bottom left y
-    
-    swordVertices.push_back(bladeWidth/2.0f);          // Blade right edge x
-    swordVertices.push_back(guardHeight/2.0f);         // Blade bottom right y
-    
-    // Add an additional triangle to make the blade look more detailed (fuller/blood groove)
-    swordVertices.push_back(0.0f);                     // Center point x
-    swordVertices.push_back(bladeLength * 0.85f);      // Center point y (85% up the blade)
-    
-    swordVertices.push_back(-bladeWidth * 0.3f);       // Left edge x (narrower than blade)
-    swordVertices.push_back(guardHeight/2.0f + bladeLength * 0.2f); // Left y (20% up the blade)
-    
-    swordVertices.push_back(bladeWidth * 0.3f);        // Right edge x (narrower than blade)
-    swordVertices.push_back(guardHeight/2.0f + bladeLength * 0.2f); // Right y (20% up the blade)
-    
-    // Guard vertices (with a crossguard shape for medieval style)
-    swordVertices.push_back(-guardWidth/2.0f);         // Guard left x
-    swordVertices.push_back(guardHeight/2.0f);         // Guard top y
-    
-    swordVertices.push_back(guardWidth/2.0f);          // Guard right x
-    swordVertices.push_back(guardHeight/2.0f);         // Guard top y
-    
-    swordVertices.push_back(guardWidth/2.0f);          // Guard right x 
-    swordVertices.push_back(-guardHeight/2.0f);        // Guard bottom y
-    
-    swordVertices.push_back(-guardWidth/2.0f);         // Guard left x
-    swordVertices.push_back(-guardHeight/2.0f);        // Guard bottom y
-    
-    // Handle vertices (rectangular) with pommel
-    swordVertices.push_back(-handleWidth/2.0f);        // Handle left x
-    swordVertices.push_back(-guardHeight/2.0f);        // Handle top y
-    
-    swordVertices.push_back(handleWidth/2.0f);         // Handle right x
-    swordVertices.push_back(-guardHeight/2.0f);        // Handle top y
-    
-    swordVertices.push_back(handleWidth/2.0f);         // Handle right x
-    swordVertices.push_back(-guardHeight/2.0f - handleLength); // Handle bottom y
-    
-    swordVertices.push_back(-handleWidth/2.0f);        // Handle left x
-    swordVertices.push_back(-guardHeight/2.0f - handleLength); // Handle bottom y
-    
-    // Add a pommel (circular end cap for the handle)
-    float pommelRadius = handleWidth * 0.8f;
-    float pommelCenterY = -guardHeight/2.0f - handleLength - pommelRadius * 0.5f;
-    
-    // Pommel center
-    swordVertices.push_back(0.0f);                    // Pommel center x
-    swordVertices.push_back(pommelCenterY);           // Pommel center y
-    
-    // Add pommel vertices (simplified circle with 8 points)
-    int pommelSegments = 8;
-    for (int i = 0; i <= pommelSegments; ++i) {
-        float angle = 2.0f * 3.14159265358979323846f * i / pommelSegments;
-        float x = pommelRadius * 0.6f * cos(angle);  // Make it slightly oval
-        float y = pommelRadius * sin(angle);
-        
-        swordVertices.push_back(x);                   // Pommel point x
-        swordVertices.push_back(pommelCenterY + y);   // Pommel point y
-    }
-    
-    // Set up VAO and VBO for sword
-    glGenVertexArrays(1, &swordVAO);
-    glGenBuffers(1, &swordVBO);
-    
-    glBindVertexArray(swordVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, swordVBO);
-    glBufferData(GL_ARRAY_BUFFER, swordVertices.size() * sizeof(float), swordVertices.data(), GL_STATIC_DRAW);
-    
-    // Our vertices are 2 floats per vertex (x, y)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
+void Game::publishSnapshot() {
+    RenderSnapshot& snapshot = snapshots.writeSlot();
+    captureSnapshot(*simulation, snapshot);
+    snapshot.alpha = tickAccumulator / simulation->getTickDuration();
+    snapshot.capturedAt = glfwGetTime();
+    snapshots.publish();
 }
 
-void Game::initArrow() {
-    // Create vertices for a 2D arrow shape
-    arrowVertices.clear();
-    
-    // Define arrow relative to origin (0,0), pointing upward (positive Y direction)
-    // Make arrow much smaller
-    float arrowLength = baseRadius * 1.5f;  // Much smaller - was 4.0f
-    float headLength = arrowLength * 0.4f;  // 40% of length is the arrowhead
-    float shaftLength = arrowLength * 0.6f; // 60% of length is the shaft
-    float headWidth = baseRadius * 0.6f;    // Much smaller width - was 1.5f
-    float shaftWidth = baseRadius * 0.15f;  // Much thinner shaft - was 0.3f
-    float fletchingLength = arrowLength * 0.25f; // Length of fletching
-    float fletchingWidth = baseRadius * 0.4f;   // Smaller fletching - was 0.8f
-    
-    // Arrowhead (triangle pointing up)
-    arrowVertices.push_back(0.0f);                    // Tip x
-    arrowVertices.push_back(arrowLength);             // Tip y
-    
-    arrowVertices.push_back(-headWidth/2.0f);         // Left base x
-    arrowVertices.push_back(arrowLength - headLength); // Left base y
-    
-    arrowVertices.push_back(headWidth/2.0f);          // Right base x
-    arrowVertices.push_back(arrowLength - headLength); // Right base y
-    
-    // Arrow shaft (rectangle)
-    arrowVertices.push_back(-shaftWidth/2.0f);        // Shaft left x
-    arrowVertices.push_back(arrowLength - headLength); // Shaft top y
-    
-    arrowVertices.push_back(shaftWidth/2.0f);         // Shaft right x
-    arrowVertices.push_back(arrowLength - headLength); // Shaft top y
-    
-    arrowVertices.push_back(shaftWidth/2.0f);         // Shaft right x
-    arrowVertices.push_back(fletchingLength);         // Shaft bottom y
-    
-    arrowVertices.push_back(-shaftWidth/2.0f);        // Shaft left x
-    arrowVertices.push_back(fletchingLength);         // Shaft bottom y
-    
-    // Fletching (feathers at the back) - left side
-    arrowVertices.push_back(-shaftWidth/2.0f);        // Fletching start left x
-    arrowVertices.push_back(fletchingLength);         // Fletching start y
-    
-    arrowVertices.push_back(-fletchingWidth/2.0f);    // Fletching end left x
-    arrowVertices.push_back(0.0f);                    // Fletching end y
-    
-    arrowVertices.push_back(-shaftWidth/4.0f);        // Fletching middle x
-    arrowVertices.push_back(fletchingLength * 0.5f);  // Fletching middle y
-    
-    // Fletching (feathers at the back) - right side
-    arrowVertices.push_back(shaftWidth/2.0f);         // Fletching start right x
-    arrowVertices.push_back(fletchingLength);         // Fletching start y
-    
-    arrowVertices.push_back(fletchingWidth/2.0f);     // Fletching end right x
-    arrowVertices.push_back(0.0f);                    // Fletching end y
-    
-    arrowVertices.push_back(shaftWidth/4.0f);         // Fletching middle x
-    arrowVertices.push_back(fletchingLength * 0.5f);  // Fletching middle y
-    
-    // Set up VAO and VBO for arrow
-    glGenVertexArrays(1, &arrowVAO);
-    glGenBuffers(1, &arrowVBO);
-    
-    glBindVertexArray(arrowVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, arrowVBO);
-    glBufferData(GL_ARRAY_BUFFER, arrowVertices.size() * sizeof(float), arrowVertices.data(), GL_STATIC_DRAW);
+void Game::renderLoop() {
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);  // Waiting for vsync here no longer holds up the simulation
     
-    // Our vertices are 2 floats per vertex (x, y)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    while (const RenderSnapshot* snapshot = snapshots.acquire()) {
+        view = snapshot;
+        renderAlpha = snapshot->alphaAt(glfwGetTime());
+        render();
+        glfwSwapBuffers(window);
+    }
     
-    glBindVertexArray(0);
+    view = nullptr;
+    glfwMakeContextCurrent(nullptr);
 }
 
-void Game::updateSword() {
-    // Update sword cooldown timer
-    if (sword.cooldownTimer > 0) {
-        sword.cooldownTimer -= deltaTime;
-        if (sword.cooldownTimer < 0) {
-            sword.cooldownTimer = 0;
-        }
+bool Game::runOffscreen() {
+    FrameCapture capture;
+    if (!capture.init(screenWidth, screenHeight)) {
+        return false;
     }
     
-    // Simple, reliable sword positioning
-    float currentTime = static_cast<float>(glfwGetTime());
-    
-    // If not swinging, sword orbits around player
-    if (!sword.isSwinging) {
-        // Simple orbital motion
-        float orbitAngle = currentTime * 0.5f; // Slow orbit
-        float orbitDistance = player->radius * 2.5f;
-        
-        sword.offsetX = cos(orbitAngle) * orbitDistance;
-        sword.offsetY = sin(orbitAngle) * orbitDistance;
-        sword.angle = orbitAngle;
-    }
-    // If swinging, do simple attack animation
-    else {
-        // Simple progress increment
-        sword.swingProgress += sword.swingSpeed * deltaTime * 60.0f;
-        
-        // If animation is complete, reset everything
-        if (sword.swingProgress >= 1.0f) {
-            // Reset to normal state
-            sword.isSwinging = false;
-            sword.swingProgress = 0.0f;
-            sword.cooldownTimer = sword.cooldown;
-            
-            // Immediately set to current orbital position
-            float orbitAngle = currentTime * 0.5f;
-            float orbitDistance = player->radius * 2.5f;
-            sword.offsetX = cos(orbitAngle) * orbitDistance;
-            sword.offsetY = sin(orbitAngle) * orbitDistance;
-            sword.angle = orbitAngle;
-            
-            std::cout << "Sword attack finished, reset to orbit" << std::endl;
+    RenderSnapshot snapshot;
+    std::vector<unsigned char> pixels;
+    std::vector<double> cpuTimes, frameTimes;
+    size_t failedFrames = 0;
+    for (int frame = 0; frame < offscreenFrames; frame++) {
+        // One tick per frame, with no input unless a recording is replayed
+        InputState tickInput;
+        if (replaying && !replay.next(tickInput)) {
+            replaying = false;
+            tickInput = InputState();
         }
-        else {
-            // Simple 3-phase attack animation
-            float attackDistance = player->radius * 1.8f; // Closer during attack
-            
-            if (sword.swingProgress < 0.33f) {
-                // Phase 1: Move to attack position (33% of animation)
-                float phase1 = sword.swingProgress / 0.33f;
-                float startAngle = sword.angle;
-                float targetAngle = startAngle + (3.14159f / 2.0f); // 90 degrees
-                
-                float currentAngle = startAngle + (targetAngle - startAngle) * phase1;
-                sword.offsetX = cos(currentAngle) * attackDistance;
-                sword.offsetY = sin(currentAngle) * attackDistance;
-                sword.angle = currentAngle;
-            }
-            else if (sword.swingProgress < 0.66f) {
-                // Phase 2: Swing around player (33% of animation)
-                float phase2 = (sword.swingProgress - 0.33f) / 0.33f;
-                float swingAngle = sword.angle + (3.14159f * 2.0f * phase2); // Full circle
-                
-                sword.offsetX = cos(swingAngle) * attackDistance;
-                sword.offsetY = sin(swingAngle) * attackDistance;
-                sword.angle = swingAngle;
-                
-                // Check for enemy hits during this phase
-                for (auto& enemy : enemies) {
-                    if (!enemy.isDead) {
-                        if (checkSwordHit(enemy.x, enemy.y, enemy.radius)) {
-                            enemy.takeDamage(sword.damage);
-                        }
-                    }
-                }
-            }
-            else {
-                // Phase 3: Return to orbit position (33% of animation)
-                float phase3 = (sword.swingProgress - 0.66f) / 0.34f;
-                float currentAngle = sword.angle;
-                float targetOrbitAngle = currentTime * 0.5f;
-                float targetDistance = player->radius * 2.5f;
-                
-                // Interpolate back to orbit
-                float finalAngle = currentAngle + (targetOrbitAngle - currentAngle) * phase3;
-                float finalDistance = attackDistance + (targetDistance - attackDistance) * phase3;
-                
-                sword.offsetX = cos(finalAngle) * finalDistance;
-                sword.offsetY = sin(finalAngle) * finalDistance;
-                sword.angle = finalAngle;
+        recorder.record(tickInput);
+        simulation->step(tickInput);
+        captureSnapshot(*simulation, snapshot);
+        view = &snapshot;
+        renderAlpha = 1.0f;
+        
+        // CPU time to issue the frame, then until the GPU has finished it
+        capture.bind();
+        auto start = std::chrono::steady_clock::now();
+        render();
+        auto issued = std::chrono::steady_clock::now();
+        glFinish();
+        auto finished = std::chrono::steady_clock::now();
+        cpuTimes.push_back(std::chrono::duration<double, std::milli>(issued - start).count());
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(finished - start).count());
+        
+        if (framesDir.empty() && goldenDir.empty()) continue;
+        capture.read(pixels);
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%04d.png", frame);
+        if (!framesDir.empty() && !writeFramePng(framesDir + "/" + name, screenWidth, screenHeight, pixels)) {
+            failedFrames++;
+        }
+        if (!goldenDir.empty()) {
+            size_t differing = 0;
+            if (!compareFramePng(goldenDir + "/" + name, screenWidth, screenHeight, pixels, 2, differing)) {
+                failedFrames++;
+            } else if (differing > 0) {
+                std::cerr << name << ": " << differing << " pixels differ from the golden image" << std::endl;
+                failedFrames++;
             }
         }
     }
+    view = nullptr;
     
-    // Debug output
-    std::cout << "Sword state - Swinging: " << sword.isSwinging 
-              << ", Progress: " << sword.swingProgress 
-              << ", Position: (" << sword.offsetX << ", " << sword.offsetY << ")" << std::endl;
+    // Summary as JSON, like knighted_bench
+    std::sort(cpuTimes.begin(), cpuTimes.end());
+    std::sort(frameTimes.begin(), frameTimes.end());
+    auto mean = [](const std::vector<double>& times) {
+        double sum = 0.0;
+        for (size_t i = 0; i < times.size(); i++) sum += times[i];
+        return times.empty() ? 0.0 : sum / times.size();
+    };
+    auto percentile = [](const std::vector<double>& sorted, double fraction) {
+        return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+    };
+    std::cout.setf(std::ios::fixed);
+    std::cout.precision(3);
+    std::cout << "{\"frames\": " << offscreenFrames
+              << ", \"width\": " << screenWidth << ", \"height\": " << screenHeight
+              << ", \"renderer\": \"" << glGetString(GL_RENDERER) << "\""
+              << ", \"cpu_ms_mean\": " << mean(cpuTimes)
+              << ", \"cpu_ms_p50\": " << percentile(cpuTimes, 0.5)
+              << ", \"cpu_ms_p99\": " << percentile(cpuTimes, 0.99)
+              << ", \"frame_ms_mean\": " << mean(frameTimes)
+              << ", \"frame_ms_p50\": " << percentile(frameTimes, 0.5)
+              << ", \"frame_ms_p99\": " << percentile(frameTimes, 0.99)
+              << ", \"failed_frames\": " << failedFrames
+              << ", \"gpu_ms_mean\": {";
+    for (int p = 0; p < PASS_COUNT; p++) {
+        std::cout << (p > 0 ? ", " : "") << "\"" << passNames[p] << "\": " << gpuProfiler->totalAverageMs(p);
+    }
+    std::cout << "}}" << std::endl;
+    return failedFrames == 0;
 }
 
-bool Game::checkSwordHit(float targetX, float targetY, float targetRadius) {
-    // Calculate the position of the sword's hitbox
-    float hitboxX = player->x + sword.offsetX;
-    float hitboxY = player->y + sword.offsetY;
+void Game::uploadMesh(const ColoredMesh& mesh, GLuint& vao, GLuint& vbo, GLuint& ebo) {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
     
-    // Check if the sword's hitbox overlaps with the target
-    float dx = hitboxX - targetX;
-    float dy = hitboxY - targetY;
-    float distance = sqrt(dx * dx + dy * dy);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(MeshVertex), mesh.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
     
-    // Return true if the sword hit the target
-    return distance < (sword.hitboxRadius + targetRadius);
+    // Position (x, y) and color (r, g, b) per vertex
+    GLsizei stride = sizeof(MeshVertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshVertex, r));
+    glEnableVertexAttribArray(1);
+    
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Game::initSword() {
+    // Blade, fuller, guard, handle and pommel in one colored mesh
+    const Simulation::Sword& sword = simulation->sword;
+    ColoredMesh mesh;
+    buildSwordMesh(sword.length, sword.width, mesh);
+    swordIndexCount = static_cast<GLsizei>(mesh.indices.size());
+    uploadMesh(mesh, swordVAO, swordVBO, swordEBO);
+}
+
+void Game::initArrow() {
+    // Head, shaft and fletching in one colored mesh
+    ColoredMesh mesh;
+    buildArrowMesh(baseRadius, mesh);
+    arrowIndexCount = static_cast<GLsizei>(mesh.indices.size());
+    uploadMesh(mesh, arrowVAO, arrowVBO, arrowEBO);
 }
 
 void Game::renderSword() {
-    if (player->isDead) return; // Don't render sword if player is dead
-    
-    // Simple check - if VAO is invalid, reinitialize
-    if (swordVAO == 0) {
-        initSword();
-        if (swordVAO == 0) return; // Still failed, skip this frame
-    }
-    
-    // Bind the sword VAO
-    glBindVertexArray(swordVAO);
-    
-    // Set sword color based on state
-    if (sword.isSwinging) {
-        // Brighter during attack
-        shaderProgram->setVec4("uColor", 0.8f, 0.9f, 1.0f, 1.0f);
-    } else {
-        // Normal steel blue
-        shaderProgram->setVec4("uColor", 0.6f, 0.7f, 0.9f, 1.0f);
-    }
+    const Player& player = view->player;
+    const Simulation::Sword& sword = view->sword;
+    if (player.isDead) return; // Don't render sword if player is dead
+    if (swordVAO == 0) return; // Mesh failed to initialize
     
     // Create model matrix for sword
     glm::mat4 model = glm::mat4(1.0f);
     
     // Position the sword at player position + offset
-    model = glm::translate(model, glm::vec3(player->x + sword.offsetX, player->y + sword.offsetY, 0.0f));
+    float offsetX = interpolate(sword.prevOffsetX, sword.offsetX, renderAlpha);
+    float offsetY = interpolate(sword.prevOffsetY, sword.offsetY, renderAlpha);
+    float playerX = interpolate(player.prevX, player.x, renderAlpha);
+    float playerY = interpolate(player.prevY, player.y, renderAlpha);
+    model = glm::translate(model, glm::vec3(playerX + offsetX, playerY + offsetY, 0.0f));
     
     // Rotate the sword to point outward from player
-    float pointingAngle = atan2(sword.offsetY, sword.offsetX) - 3.14159f / 2.0f;
+    float pointingAngle = atan2(offsetY, offsetX) - 3.14159f / 2.0f;
     model = glm::rotate(model, pointingAngle, glm::vec3(0.0f, 0.0f, 1.0f));
     
-    // Apply the model matrix
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    
     // Simple scale effect during swing
     float scale = sword.isSwinging ? 1.2f : 1.0f;
-    shaderProgram->setFloat("uScale", scale);
-    
-    // Draw the sword parts with different colors
-    
-    // Main blade triangle
-    shaderProgram->setVec4("uColor", 0.7f, 0.8f, 0.95f, 1.0f);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    
-    // Blade detail/fuller
-    shaderProgram->setVec4("uColor", 0.5f, 0.6f, 0.8f, 1.0f);
-    glDrawArrays(GL_TRIANGLES, 3, 3);
-    
-    // Guard - gold color
-    shaderProgram->setVec4("uColor", 0.9f, 0.7f, 0.2f, 1.0f);
-    glDrawArrays(GL_TRIANGLE_FAN, 6, 4);
-    
-    // Handle - brown color
-    shaderProgram->setVec4("uColor", 0.6f, 0.3f, 0.1f, 1.0f);
-    glDrawArrays(GL_TRIANGLE_FAN, 10, 4);
-    
-    // Pommel - gold to match guard
-    shaderProgram->setVec4("uColor", 0.9f, 0.7f, 0.2f, 1.0f);
-    glDrawArrays(GL_TRIANGLE_FAN, 14, 10);
-    
-    // Reset scale
-    shaderProgram->setFloat("uScale", 1.0f);
+    model = glm::scale(model, glm::vec3(scale, scale, 1.0f));
     
-    glBindVertexArray(0);
+    // All parts in one draw
+    queueMesh(swordVAO, swordIndexCount, model);
 }
 
-void Game::renderArrow() {
-    if (!arrowActive || player->isDead) return; // Don't render if arrow is not active or player is dead
-    
-    // Simple check - if VAO is invalid, reinitialize
-    if (arrowVAO == 0) {
-        initArrow();
-        if (arrowVAO == 0) return; // Still failed, skip this frame
-    }
-    
-    // Bind the arrow VAO
-    glBindVertexArray(arrowVAO);
+void Game::renderArrow(const RenderSnapshot::Projectile& projectile) {
+    if (arrowVAO == 0) return; // Mesh failed to initialize
     
     // Create model matrix for arrow
     glm::mat4 model = glm::mat4(1.0f);
     
     // Position the arrow at its current location
-    model = glm::translate(model, glm::vec3(arrow.x, arrow.y, 0.0f));
+    float arrowX = interpolate(projectile.prevX, projectile.x, renderAlpha);
+    float arrowY = interpolate(projectile.prevY, projectile.y, renderAlpha);
+    model = glm::translate(model, glm::vec3(arrowX, arrowY, 0.0f));
     
     // Rotate the arrow to point in its direction of travel
-    model = glm::rotate(model, arrow.angle, glm::vec3(0.0f, 0.0f, 1.0f));
+    // (subtract 90 degrees since the arrow mesh points up by default)
+    float angle = std::atan2(projectile.vy, projectile.vx) - 3.14159f / 2.0f;
+    model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
     
     // Scale the arrow to be much smaller
-    float arrowScale = 0.4f; // Much smaller scale - was 0.8f
+    float arrowScale = 0.4f;
     model = glm::scale(model, glm::vec3(arrowScale, arrowScale, 1.0f));
     
-    // Apply the model matrix
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    
-    // Draw the arrow parts with different colors
-    
-    // Arrowhead (metallic silver/gray)
-    shaderProgram->setVec4("uColor", 0.8f, 0.8f, 0.9f, 1.0f);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    
-    // Arrow shaft (brown wood color)
-    shaderProgram->setVec4("uColor", 0.6f, 0.4f, 0.2f, 1.0f);
-    glDrawArrays(GL_TRIANGLE_FAN, 3, 4);
-    
-    // Fletching left (feather color - reddish brown)
-    shaderProgram->setVec4("uColor", 0.7f, 0.3f, 0.2f, 1.0f);
-    glDrawArrays(GL_TRIANGLES, 7, 3);
-    
-    // Fletching right (feather color - reddish brown)
-    shaderProgram->setVec4("uColor", 0.7f, 0.3f, 0.2f, 1.0f);
-    glDrawArrays(GL_TRIANGLES, 10, 3);
-    
-    glBindVertexArray(0);
+    // All parts in one draw
+    queueMesh(arrowVAO, arrowIndexCount, model);
 }
 
 void Game::initTerrain() {
-    // Create a simple rectangle for terrain element rendering
-    tileVertices = {
-        // positions (x, y) for a unit square
-        0.0f, 0.0f,  // bottom left
-        1.0f, 0.0f,  // bottom right
-        1.0f, 1.0f,  // top right
-        0.0f, 0.0f,  // bottom left
-        1.0f, 1.0f,  // top right
-        0.0f, 1.0f   // top left
-    };
+    // Generate the scattered terrain elements
+    generateTerrain();
     
-    // Set up VAO and VBO for terrain elements
+    // Terrain never changes, so bake it once into a static world-space mesh
+    std::vector<TerrainVertex> terrainMesh;
+    buildTerrainMesh(terrainElements, terrainMesh);
+    terrainVertexCount = static_cast<GLsizei>(terrainMesh.size());
+    
+    // Set up VAO and VBO for the baked mesh
     glGenVertexArrays(1, &tileVAO);
     glGenBuffers(1, &tileVBO);
     
     glBindVertexArray(tileVAO);
     glBindBuffer(GL_ARRAY_BUFFER, tileVBO);
-    glBufferData(GL_ARRAY_BUFFER, tileVertices.size() * sizeof(float), tileVertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, terrainMesh.size() * sizeof(TerrainVertex), terrainMesh.data(), GL_STATIC_DRAW);
     
-    // Our vertices are 2 floats per vertex (x, y)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    // Position (x, y) and color (r, g, b) per vertex
+    GLsizei stride = sizeof(TerrainVertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TerrainVertex, x));
     glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TerrainVertex, r));
+    glEnableVertexAttribArray(1);
     
     glBindVertexArray(0);
-    
-    // Generate the scattered terrain elements
-    generateTerrain();
 }
 
 void Game::generateTerrain() {
     if (terrainGenerated) return;
     
-    // Calculate world bounds
-    float aspect = static_cast<float>(screenWidth) / screenHeight;
-    float worldWidth = 2.0f * aspect;
-    float worldHeight = 2.0f;
-    
-    // Clear any existing terrain elements
-    terrainElements.clear();
-    
-    // Generate scattered terrain elements
-    int numElements = 150; // Total number of terrain elements to scatter
-    
-    for (int i = 0; i < numElements; i++) {
-        TerrainElement element;
-        
-        // Random position across the world
-        element.x = randomFloat(-aspect + 0.1f, aspect - 0.1f);
-        element.y = randomFloat(-1.0f + 0.1f, 1.0f - 0.1f);
-        
-        // Check for overlap with existing elements (minimum distance)
-        bool tooClose = false;
-        float minDistance = 0.15f; // Minimum distance between elements
-        
-        for (const auto& existing : terrainElements) {
-            float dx = element.x - existing.x;
-            float dy = element.y - existing.y;
-            float distance = sqrt(dx * dx + dy * dy);
-            
-            if (distance < minDistance) {
-                tooClose = true;
-                break;
-            }
-        }
-        
-        // Skip this element if it's too close to another
-        if (tooClose) {
-            i--; // Try again
-            continue;
-        }
-        
-        // Random element type
-        int typeRand = rand() % 100;
-        if (typeRand < 35) {
-            element.type = GRASS_BLADE;
-            element.size = randomFloat(0.02f, 0.04f);
-        } else if (typeRand < 55) {
-            element.type = STONE_ROCK;
-            element.size = randomFloat(0.03f, 0.06f);
-        } else if (typeRand < 75) {
-            element.type = DIRT_PATCH;
-            element.size = randomFloat(0.025f, 0.045f);
-        } else if (typeRand < 90) {
-            element.type = COBBLE_STONE;
-            element.size = randomFloat(0.04f, 0.07f);
-        } else {
-            element.type = SAND_GRAIN;
-            element.size = randomFloat(0.015f, 0.025f);
-        }
-        
-        // Random rotation for variety
-        element.rotation = randomFloat(0.0f, 6.28318f); // 0 to 2π
-        
-        // Grayscale colors with variation
-        float baseGray = 0.0f;
-        float variation = randomFloat(0.7f, 1.0f);
-        
-        switch (element.type) {
-            case GRASS_BLADE:
-                baseGray = 0.4f * variation; // Medium gray
-                break;
-            case STONE_ROCK:
-                baseGray = 0.6f * variation; // Light gray
-                break;
-            case DIRT_PATCH:
-                baseGray = 0.3f * variation; // Dark gray
-                break;
-            case COBBLE_STONE:
-                baseGray = 0.5f * variation; // Medium-light gray
-                break;
-            case SAND_GRAIN:
-                baseGray = 0.7f * variation; // Lightest gray
-                break;
-        }
-        
-        element.color = glm::vec3(baseGray, baseGray, baseGray);
-        element.rendered = false; // Will be rendered once and then marked as rendered
-        
-        terrainElements.push_back(element);
-    }
+    // Scatter elements across the visible world
+    TerrainSettings settings;
+    settings.halfWidth = static_cast<float>(screenWidth) / screenHeight;
+    settings.halfHeight = 1.0f;
+    ::generateTerrain(settings, simulation->getConfig().seed, terrainElements);
     
     terrainGenerated = true;
     std::cout << "Generated " << static_cast<int>(terrainElements.size()) << " scattered terrain elements" << std::endl;
 }
 
 void Game::renderTerrain() {
-    if (!terrainGenerated || tileVAO == 0) return;
+    if (!terrainGenerated || tileVAO == 0 || terrainVertexCount == 0) return;
     
-    // Bind the terrain VAO
-    glBindVertexArray(tileVAO);
-    
-    // Render all terrain elements
-    for (auto& element : terrainElements) {
-        // Set element color
-        shaderProgram->setVec4("uColor", element.color.r, element.color.g, element.color.b, 1.0f);
-        
-        // Create model matrix for this element
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(element.x, element.y, 0.0f));
-        model = glm::rotate(model, element.rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-        
-        // Draw different shapes based on element type
-        switch (element.type) {
-            case GRASS_BLADE:
-            {
-                // Draw thin vertical rectangle for grass blade
-                glm::mat4 grassModel = model;
-                grassModel = glm::scale(grassModel, glm::vec3(element.size * 0.3f, element.size * 2.0f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(grassModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                break;
-            }
-                
-            case STONE_ROCK:
-            {
-                // Draw irregular stone shape (multiple small rectangles)
-                glm::mat4 stoneModel = model;
-                stoneModel = glm::scale(stoneModel, glm::vec3(element.size, element.size * 0.8f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(stoneModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                
-                // Add a smaller rectangle for irregular shape
-                glm::mat4 model2 = glm::mat4(1.0f);
-                model2 = glm::translate(model2, glm::vec3(element.x + element.size * 0.3f, element.y + element.size * 0.2f, 0.0f));
-                model2 = glm::rotate(model2, element.rotation + 0.5f, glm::vec3(0.0f, 0.0f, 1.0f));
-                model2 = glm::scale(model2, glm::vec3(element.size * 0.6f, element.size * 0.5f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(model2));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                break;
-            }
-                
-            case DIRT_PATCH:
-            {
-                // Draw small square for dirt patch
-                glm::mat4 dirtModel = model;
-                dirtModel = glm::scale(dirtModel, glm::vec3(element.size, element.size, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(dirtModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                break;
-            }
-                
-            case COBBLE_STONE:
-            {
-                // Draw rectangular cobblestone
-                glm::mat4 cobbleModel = model;
-                cobbleModel = glm::scale(cobbleModel, glm::vec3(element.size * 1.2f, element.size * 0.8f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(cobbleModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                
-                // Add border lines for cobblestone effect
-                float darkGray = element.color.r * 0.5f;
-                shaderProgram->setVec4("uColor", darkGray, darkGray, darkGray, 1.0f);
-                
-                // Top border
-                glm::mat4 borderModel = glm::mat4(1.0f);
-                borderModel = glm::translate(borderModel, glm::vec3(element.x, element.y + element.size * 0.4f, 0.0f));
-                borderModel = glm::rotate(borderModel, element.rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-                borderModel = glm::scale(borderModel, glm::vec3(element.size * 1.2f, element.size * 0.05f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(borderModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                
-                // Side border
-                borderModel = glm::mat4(1.0f);
-                borderModel = glm::translate(borderModel, glm::vec3(element.x + element.size * 0.6f, element.y, 0.0f));
-                borderModel = glm::rotate(borderModel, element.rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-                borderModel = glm::scale(borderModel, glm::vec3(element.size * 0.05f, element.size * 0.8f, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(borderModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                break;
-            }
-                
-            case SAND_GRAIN:
-            {
-                // Draw tiny square for sand grain
-                glm::mat4 sandModel = model;
-                sandModel = glm::scale(sandModel, glm::vec3(element.size, element.size, 1.0f));
-                shaderProgram->setMat4("uModel", glm::value_ptr(sandModel));
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                break;
-            }
-        }
-    }
-    
-    glBindVertexArray(0);
-}
-
-void Game::checkWinCondition() {
-    // Check if we've killed enough enemies to win
-    if (!gameWon && totalEnemiesKilled >= enemiesToKill) {
-        gameWon = true;
-        winTime = static_cast<float>(glfwGetTime());
-        std::cout << "Victory! You killed " << totalEnemiesKilled << " enemies!" << std::endl;
-    }
+    // The whole baked terrain is one draw
+    static const glm::mat4 identity(1.0f);
+    DrawCommand& command = renderQueue.add(RENDER_TERRAIN, meshShader->ID, tileVAO, 0);
+    command.count = terrainVertexCount;
+    command.setModel(meshModelUniform.location, glm::value_ptr(identity));
 }
 
 void Game::renderWinScreen() {
-    // Bind the rectangle VAO
-    glBindVertexArray(rectVAO);
-    
-    // Fill the screen with green overlay
+    // Fill the screen with a semi-transparent green overlay
     float aspect = static_cast<float>(screenWidth) / screenHeight;
-    shaderProgram->setVec4("uColor", 0.0f, 0.3f, 0.0f, 0.7f); // Semi-transparent green
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(-aspect, -1.0f, 0.0f)); // Bottom-left corner
-    model = glm::scale(model, glm::vec3(2.0f * aspect, 2.0f, 1.0f)); // Scale to fill screen
-    shaderProgram->setMat4("uModel", glm::value_ptr(model));
-    
-    // Enable blending for transparent overlay
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
+    quadBatch->setLayer(RENDER_OVERLAY);
+    quadBatch->addQuad(-aspect, -1.0f, 2.0f * aspect, 2.0f, glm::vec4(0.0f, 0.3f, 0.0f, 0.7f));
+}
+
+void Game::renderWinText() {
     // Render text with proper font rendering
     if (gameFont) {
         // Center "VICTORY!" text on screen
-        const std::string victoryMessage = "VICTORY!";
-        float textScale = 2.5f;
-        
-        // Calculate width of text (approximate)
-        float textWidth = victoryMessage.length() * 20.0f * textScale;
-        
-        // Position text in center of screen
-        float textX = (screenWidth - textWidth) / 2.0f;
+        float textX = (screenWidth - winTitleText.width()) / 2.0f;
         float textY = screenHeight / 2.0f + 50.0f;
         
-        // Draw "VICTORY!" text - gold color
-        gameFont->renderText(victoryMessage, textX, textY, textScale, glm::vec3(1.0f, 0.8f, 0.0f));
-        
-        // Draw kill count below
-        std::string killMessage = "Enemies Defeated: " + std::to_string(totalEnemiesKilled);
-        float killScale = 1.5f;
-        
-        // Position kill count text below main message
-        float killWidth = killMessage.length() * 10.0f * killScale;
-        float killX = (screenWidth - killWidth) / 2.0f;
+        // Draw "VICTORY!" text - gold with a brown outline and warm glow
+        TextEffects titleEffects;
+        titleEffects.outlineColor = glm::vec3(0.3f, 0.15f, 0.0f);
+        titleEffects.outlineWidth = 1.5f;
+        titleEffects.glowColor = glm::vec4(1.0f, 0.9f, 0.3f, 0.5f);
+        titleEffects.glowWidth = 4.0f;
+        winTitleText.draw(textX, textY, glm::vec3(1.0f, 0.8f, 0.0f), titleEffects);
+        
+        // Draw kill count below, laid out again only if it changed
+        if (winKillsValue != view->kills) {
+            winKillsValue = view->kills;
+            char killMessage[64];
+            std::snprintf(killMessage, sizeof(killMessage), "Enemies Defeated: %d", winKillsValue);
+            winKillsText.set(gameFont, killMessage, 1.5f);
+        }
+        float killX = (screenWidth - winKillsText.width()) / 2.0f;
         float killY = textY - 80.0f;
+        winKillsText.draw(killX, killY, glm::vec3(1.0f, 1.0f, 1.0f));
         
-        gameFont->renderText(killMessage, killX, killY, killScale, glm::vec3(1.0f, 1.0f, 1.0f));
-        
-        // Draw instruction text below
-        const std::string exitMessage = "Press ESC to exit";
-        float instructionScale = 1.0f;
-        
-        // Position instruction text below kill count
-        float instructionWidth = exitMessage.length() * 10.0f * instructionScale;
-        float instructionX = (screenWidth - instructionWidth) / 2.0f;
+        // Draw instruction text below kill count
+        float instructionX = (screenWidth - exitHintText.width()) / 2.0f;
         float instructionY = killY - 50.0f;
-        
-        gameFont->renderText(exitMessage, instructionX, instructionY, instructionScale, glm::vec3(0.9f, 0.9f, 0.9f));
+        exitHintText.draw(instructionX, instructionY, glm::vec3(0.9f, 0.9f, 0.9f));
     }
-    
-    // Disable blending
-    glDisable(GL_BLEND);
-    
-    glBindVertexArray(0);
 }
 
 void Game::renderKillCounter() {
     if (gameFont) {
-        // Create kill counter text
-        std::string killText = "Kills: " + std::to_string(totalEnemiesKilled) + "/" + std::to_string(enemiesToKill);
-        float textScale = 1.0f;
-        
-        // Calculate text width (approximate)
-        float textWidth = killText.length() * 12.0f * textScale;
+        // Kill counter text only changes on a kill
+        if (killCounterValue != view->kills) {
+            killCounterValue = view->kills;
+            char killText[64];
+            std::snprintf(killText, sizeof(killText), "Kills: %d/%d", killCounterValue, view->killTarget);
+            killCounterText.set(gameFont, killText, 1.0f);
+        }
         
         // Position in top right corner with padding
-        float aspect = static_cast<float>(screenWidth) / screenHeight;
-        float textX = screenWidth - textWidth - 20.0f; // 20px padding from right edge
+        float textX = screenWidth - killCounterText.width() - 20.0f; // 20px padding from right edge
         float textY = screenHeight - 30.0f; // 30px from top
         
         // Draw kill counter - white color
-        gameFont->renderText(killText, textX, textY, textScale, glm::vec3(1.0f, 1.0f, 1.0f));
+        killCounterText.draw(textX, textY, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
+}
+
+// Graph layout in screen pixels from the bottom left corner
+static const float GPU_GRAPH_MARGIN = 20.0f;
+static const float GPU_GRAPH_ROW = 28.0f;
+static const float GPU_GRAPH_LABEL_WIDTH = 230.0f;
+static const float GPU_GRAPH_BAR_WIDTH = 300.0f;
+static const float GPU_GRAPH_BAR_HEIGHT = 18.0f;
+
+void Game::renderGpuTimes() {
+    // Pixels to world space, which the quad batch draws in
+    float aspect = static_cast<float>(screenWidth) / screenHeight;
+    float pixel = 2.0f / screenHeight;
+    
+    // Backdrop behind the labels and bars
+    float panelWidth = GPU_GRAPH_LABEL_WIDTH + GPU_GRAPH_BAR_WIDTH + 2.0f * GPU_GRAPH_MARGIN;
+    float panelHeight = PASS_COUNT * GPU_GRAPH_ROW + GPU_GRAPH_MARGIN;
+    quadBatch->setLayer(RENDER_OVERLAY);
+    quadBatch->addQuad(-aspect, -1.0f, panelWidth * pixel, panelHeight * pixel, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+    
+    // A full bar is the slowest pass, but never less than a millisecond
+    float fullScaleMs = 1.0f;
+    for (int p = 0; p < PASS_COUNT; p++) {
+        fullScaleMs = std::max(fullScaleMs, gpuProfiler->averageMs(p));
+    }
+    
+    // First pass on top; the fill is the pass's share of the full bar
+    for (int p = 0; p < PASS_COUNT; p++) {
+        float rowY = GPU_GRAPH_MARGIN + (PASS_COUNT - 1 - p) * GPU_GRAPH_ROW;
+        float barX = GPU_GRAPH_MARGIN + GPU_GRAPH_LABEL_WIDTH;
+        float fill = gpuProfiler->averageMs(p) / fullScaleMs;
+        quadBatch->addQuad(-aspect + barX * pixel, -1.0f + rowY * pixel,
+                           GPU_GRAPH_BAR_WIDTH * pixel, GPU_GRAPH_BAR_HEIGHT * pixel,
+                           glm::vec4(0.2f, 0.8f, 0.3f, 0.9f), fill);
+    }
+}
+
+void Game::renderGpuTimesText() {
+    if (!gameFont) return;
+    
+    for (int p = 0; p < PASS_COUNT; p++) {
+        // The averages change once per window, so the labels rarely do
+        float ms = gpuProfiler->averageMs(p);
+        if (gpuPassShownMs[p] != ms) {
+            gpuPassShownMs[p] = ms;
+            char label[64];
+            std::snprintf(label, sizeof(label), "%s %.3f ms", passNames[p], ms);
+            gpuPassText[p].set(gameFont, label, 0.4f);
+        }
+        float rowY = GPU_GRAPH_MARGIN + (PASS_COUNT - 1 - p) * GPU_GRAPH_ROW;
+        gpuPassText[p].draw(GPU_GRAPH_MARGIN, rowY + 3.0f, glm::vec3(1.0f, 1.0f, 1.0f));
     }
 }
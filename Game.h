@@ -4,11 +4,23 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <thread>
+#include <atomic>
 #include "Shader.h"
-#include "Player.h"
-#include "Enemy.h"
+#include "Simulation.h"
+#include "RenderSnapshot.h"
+#include "InputRecording.h"
+#include "Terrain.h"
+#include "WeaponMesh.h"
 #include "Font.h"
+#include "TextLayout.h"
+#include "QuadBatch.h"
+#include "ShapeBatch.h"
+#include "RenderQueue.h"
+#include "StreamArena.h"
+#include "GpuProfiler.h"
 #include "dependente/glew/glew.h"
+#include "dependente/glfw/glfw3.h"
 #include "dependente/glm/glm.hpp"
 
 class Game {
@@ -20,25 +32,55 @@ public:
     void run();
     void cleanup();
 
+    // Render setFrameCount frames without a visible window (see
+    // setOffscreen) and report render times; false if a frame differed
+    // from its golden image or could not be saved
+    bool runOffscreen();
+
+    // Call before init(). Recording writes every tick's input to a file;
+    // replaying runs the recorded game (same settings and seed) from a file
+    // instead of the keyboard and mouse, then hands control back.
+    void setRecordPath(const std::string& path) { recordPath = path; }
+    void setReplayPath(const std::string& path) { replayPath = path; }
+
+    // Call before init(). Offscreen mode renders into a framebuffer object
+    // of a hidden window, one simulation tick per frame with a fixed seed.
+    // Frames are written as PNGs to framesDir and compared with the PNGs of
+    // the same name in goldenDir, when those are set.
+    void setOffscreen(int frameCount, bool useEgl) { offscreenFrames = frameCount; offscreenEgl = useEgl; }
+    void setFramesDir(const std::string& dir) { framesDir = dir; }
+    void setGoldenDir(const std::string& dir) { goldenDir = dir; }
+
+    // Simulation seed; 0 picks one from the clock (offscreen mode uses 1)
+    void setSeed(uint64_t value) { seed = value; }
+
 private:
     void processInput();
-    void update();
-    void render();
+    int update();              // Runs the ticks that are due; returns how many
+    void render();             // Draws *view (render thread only)
+
+    // Hand the simulation's current state to the render thread
+    void publishSnapshot();
+
+    // Render thread: draws the newest snapshot until the buffer is stopped
+    void renderLoop();
     void renderHealthBar();
     void renderKillCounter();
-    void renderEnemyHealthBar(const Enemy& enemy);
+    void renderEnemyHealthBar(const RenderSnapshot::Enemy& enemy, float enemyX, float enemyY);
     void renderDeathScreen();
-    void spawnEnemies(int count);
+    void renderDeathText();
+    bool isDeathScreenVisible() const;
+    
+    // Queue the player, enemies and enemy arrows as analytic shapes
+    void renderCircles();
     
-    // Sword rendering and update functions
+    // Sword rendering functions
     void initSword();
-    void updateSword();
     void renderSword();
-    bool checkSwordHit(float targetX, float targetY, float targetRadius);
     
     // Arrow rendering functions
     void initArrow();
-    void renderArrow();
+    void renderArrow(const RenderSnapshot::Projectile& projectile);
     
     // Terrain system functions
     void initTerrain();
@@ -47,112 +89,110 @@ private:
     
     // Game state functions
     void renderWinScreen();
-    void checkWinCondition();
+    void renderWinText();
+    
+    // GPU time per pass as a bar graph in the bottom left corner: the
+    // bars go through the queue, the labels are drawn after it
+    void renderGpuTimes();
+    void renderGpuTimesText();
+    
+    // Create a VAO with vertex and index buffers for a colored mesh
+    void uploadMesh(const ColoredMesh& mesh, GLuint& vao, GLuint& vbo, GLuint& ebo);
+
+    // Queue one indexed draw of a weapon mesh with meshShader
+    void queueMesh(GLuint vao, GLsizei indexCount, const glm::mat4& model);
     
     // Timing variables
     double lastFrameTime;
-    float deltaTime;
+    float deltaTime;           // Wall-clock time of the last frame
+    float tickAccumulator;     // Frame time not yet consumed by simulation ticks
+    int maxTicksPerFrame;      // Cap on catch-up ticks after a slow frame
+    float renderAlpha;         // Blend factor between previous and current tick (0..1), render thread only
 
     GLFWwindow* window;
     int screenWidth, screenHeight;
-    Shader* shaderProgram;
     Shader* textShader;
+    Shader* shapeShader;       // Analytic shapes (shape_vertex.glsl)
+    Shader* quadShader;        // Batched quads (quad_vertex.glsl)
+    Shader* meshShader;        // Static vertex-colored meshes (mesh_vertex.glsl)
+    FrameUniforms frameUniforms;  // Projections and time shared by all shaders
+
+    // Uniform handle of meshShader, resolved once after linking
+    Shader::UniformMat4 meshModelUniform;
     Font* gameFont;
 
-    // For drawing circles (player, enemy, arrow)
-    GLuint circleVAO, circleVBO;
-    std::vector<float> circleVertices;
-    int segments;       // Number of segments in circle (e.g., 50)
-    float baseRadius;   // Base radius for the circles (player & enemy)
+    // HUD and end screen text, laid out only when it changes
+    TextLayout killCounterText;
+    TextLayout deathTitleText, winTitleText, winKillsText, exitHintText;
+    int killCounterValue;      // Kills shown by killCounterText (-1 = none yet)
+    int winKillsValue;         // Kills shown by winKillsText
 
-    // For drawing rectangles (health bar, death screen)
-    GLuint rectVAO, rectVBO;
-    
-    // For drawing the sword
-    GLuint swordVAO, swordVBO;
-    std::vector<float> swordVertices;
+    float baseRadius;   // Radius of the player, and base radius of enemies
+
+    // Vertex space for everything rebuilt each frame (quads, shapes,
+    // dynamic text)
+    StreamArena* streamArena;
+
+    // Circles, projectiles and health bars, drawn in as few batches as possible
+    ShapeBatch* shapeBatch;
+
+    // Screen overlays
+    QuadBatch* quadBatch;
+
+    // Every draw except text goes through the queue, sorted by layer and state
+    RenderQueue renderQueue;
+    GLStateCache glState;
+
+    // GPU time of each render layer plus text; F3 toggles the bar graph
+    GpuProfiler* gpuProfiler;
+    std::atomic<bool> showGpuTimes;   // Set by processInput, read by render
+    bool gpuTimesKeyDown;             // F3 state last frame, for edge detection
+    TextLayout gpuPassText[GpuProfiler::MAX_PASSES];
+    float gpuPassShownMs[GpuProfiler::MAX_PASSES];  // Times shown by gpuPassText
     
-    // For drawing arrows
-    GLuint arrowVAO, arrowVBO;
-    std::vector<float> arrowVertices;
+    // Weapon meshes (indexed, colored per vertex), one draw per weapon
+    GLuint swordVAO, swordVBO, swordEBO;
+    GLsizei swordIndexCount;
+    GLuint arrowVAO, arrowVBO, arrowEBO;
+    GLsizei arrowIndexCount;
 
-    // For drawing background tiles
+    // Baked terrain mesh, built once in initTerrain
     GLuint tileVAO, tileVBO;
-    std::vector<float> tileVertices;
-    
-    // Tile system
-    enum TileType {
-        GRASS_BLADE = 0,
-        STONE_ROCK = 1,
-        DIRT_PATCH = 2,
-        COBBLE_STONE = 3,
-        SAND_GRAIN = 4
-    };
-    
-    struct TerrainElement {
-        TileType type;
-        float x, y;
-        float size;
-        float rotation; // For variety
-        glm::vec3 color;
-        bool rendered; // To avoid re-rendering static elements
-    };
+    GLsizei terrainVertexCount;
     
+    // Scattered background terrain
     std::vector<TerrainElement> terrainElements;
     bool terrainGenerated;
 
     glm::mat4 projection; // Orthographic projection matrix
     glm::mat4 textProjection; // Orthographic projection for text (in screen coordinates)
 
-    // Game entities:
-    Player* player;
-    std::vector<Enemy> enemies;
-    float enemySpeed;
-    int maxEnemies;
-    int totalEnemiesSpawned;  // Track total enemies ever spawned
-    float enemySpawnTimer;
-    float enemySpawnInterval;
-
-    // Arrow projectile:
-    struct Arrow {
-        float x, y;
-        float vx, vy;
-        float radius;
-        float angle;  // Rotation angle for proper arrow orientation
-    } arrow;
-    bool arrowActive;
-    bool mouseWasPressed;
-    float arrowSpeed;
-    
-    // Sword properties:
-    struct Sword {
-        float offsetX, offsetY;    // Offset from player position
-        float angle;               // Current angle in radians
-        float length;              // Length of the sword
-        float width;               // Width of the sword blade
-        float hitboxRadius;        // Radius of the sword's hit area
-        bool isSwinging;           // Whether the sword is currently in swing animation
-        float swingSpeed;          // Speed of the swing animation in radians per frame
-        float swingAngle;          // Total angle to swing
-        float swingProgress;       // Current progress of swing (0.0 to 1.0)
-        float damage;              // Damage dealt by the sword
-        float cooldown;            // Cooldown between swings
-        float cooldownTimer;       // Current cooldown timer
-    } sword;
-    bool rightMouseWasPressed;     // Track right mouse button state
-
-    // Test damage
-    float damageTimer;
-    float damageCooldown;
-    
+    // Game simulation (player, enemies, weapons, win/death state)
+    Simulation* simulation;
+    InputState input;          // Controls sampled by processInput for the next update
+
+    // The main thread simulates and publishes snapshots; the render thread
+    // owns the GL context and draws the newest one
+    SnapshotBuffer snapshots;
+    std::thread renderThread;
+    const RenderSnapshot* view;  // Snapshot being drawn (render thread only)
+
+    // Input recording and replay
+    std::string recordPath;
+    std::string replayPath;
+    InputRecorder recorder;
+    InputReplay replay;
+    bool replaying;
+    uint64_t seed;
+
+    // Offscreen rendering
+    int offscreenFrames;       // 0 = normal windowed game
+    bool offscreenEgl;         // Create the context through EGL
+    std::string framesDir;
+    std::string goldenDir;
+
     // Death screen
     float deathScreenTimeout;
-    
-    // Win condition
-    bool gameWon;
-    float winTime;
-    int totalEnemiesKilled;
-    int enemiesToKill; // Number of enemies needed to win
 };
 
 #endif
@@ -0,0 +1,105 @@
+#include "GpuProfiler.h"
+#include <iostream>
+
+GpuProfiler::GpuProfiler() : passCount(0), slot(0), activePass(-1), windowFrames(0) {
+    for (int s = 0; s < LATENCY; s++) {
+        for (int p = 0; p < MAX_PASSES; p++) {
+            queries[s][p] = 0;
+            issued[s][p] = false;
+        }
+    }
+    for (int p = 0; p < MAX_PASSES; p++) {
+        windowSum[p] = 0.0;
+        windowCount[p] = 0;
+        average[p] = 0.0f;
+        totalSum[p] = 0.0;
+        totalCount[p] = 0;
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (passCount > 0) {
+        for (int s = 0; s < LATENCY; s++) {
+            glDeleteQueries(passCount, queries[s]);
+        }
+    }
+}
+
+bool GpuProfiler::init(int count) {
+    if (count <= 0 || count > MAX_PASSES) {
+        std::cerr << "GpuProfiler supports 1 to " << MAX_PASSES << " passes" << std::endl;
+        return false;
+    }
+    passCount = count;
+    for (int s = 0; s < LATENCY; s++) {
+        glGenQueries(passCount, queries[s]);
+    }
+    return true;
+}
+
+void GpuProfiler::beginFrame() {
+    if (passCount == 0) return;
+    endPass();
+
+    // The slot about to be reused was issued LATENCY frames ago
+    slot = (slot + 1) % LATENCY;
+    collect(slot);
+
+    windowFrames++;
+    if (windowFrames >= AVERAGE_FRAMES) {
+        for (int p = 0; p < passCount; p++) {
+            average[p] = windowCount[p] > 0 ? static_cast<float>(windowSum[p] / windowCount[p]) : 0.0f;
+            windowSum[p] = 0.0;
+            windowCount[p] = 0;
+        }
+        windowFrames = 0;
+    }
+}
+
+void GpuProfiler::collect(int frameSlot) {
+    for (int p = 0; p < passCount; p++) {
+        if (!issued[frameSlot][p]) continue;
+        issued[frameSlot][p] = false;
+
+        // Never wait for the GPU; a late result is simply not counted
+        GLint available = 0;
+        glGetQueryObjectiv(queries[frameSlot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[frameSlot][p], GL_QUERY_RESULT, &nanoseconds);
+        double ms = nanoseconds / 1.0e6;
+        windowSum[p] += ms;
+        windowCount[p]++;
+        totalSum[p] += ms;
+        totalCount[p]++;
+    }
+}
+
+void GpuProfiler::beginPass(int pass) {
+    if (pass < 0 || pass >= passCount) return;
+    endPass();
+
+    // A pass run twice in one frame keeps only its last query
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot][pass]);
+    issued[slot][pass] = true;
+    activePass = pass;
+}
+
+void GpuProfiler::endPass() {
+    if (activePass < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = -1;
+}
+
+float GpuProfiler::totalAverageMs(int pass) const {
+    return totalCount[pass] > 0 ? static_cast<float>(totalSum[pass] / totalCount[pass]) : 0.0f;
+}
+
+float GpuProfiler::frameMs() const {
+    float sum = 0.0f;
+    for (int p = 0; p < passCount; p++) {
+        sum += average[p];
+    }
+    return sum;
+}
@@ -0,0 +1,62 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include "dependente/glew/glew.h"
+
+// GPU time of each render pass, measured with GL_TIME_ELAPSED queries.
+// Queries are read back LATENCY - 1 frames after they were issued and only
+// if the GPU has already finished them, so profiling never stalls; a
+// sample that is still not ready by then is dropped. Samples are averaged
+// over AVERAGE_FRAMES frames so the numbers are readable on screen.
+//
+// Passes are numbered by the caller. Time elapsed queries cannot nest, so
+// beginPass() ends the pass that is still running.
+class GpuProfiler {
+public:
+    static const int MAX_PASSES = 8;
+    static const int LATENCY = 4;           // Frames of queries in flight
+    static const int AVERAGE_FRAMES = 30;
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    bool init(int passCount);
+
+    // Call once per frame before the first pass
+    void beginFrame();
+
+    void beginPass(int pass);
+    void endPass();
+
+    // Average GPU milliseconds of a pass over the last complete window
+    float averageMs(int pass) const { return average[pass]; }
+
+    // Average GPU milliseconds of a pass over every sample since init
+    float totalAverageMs(int pass) const;
+
+    // Sum of the pass averages
+    float frameMs() const;
+
+    int getPassCount() const { return passCount; }
+
+private:
+    // Read the queries issued in a frame slot that the GPU has finished
+    void collect(int slot);
+
+    int passCount;
+    int slot;                               // Slot of the current frame
+    int activePass;                         // -1 when no query is running
+    GLuint queries[LATENCY][MAX_PASSES];
+    bool issued[LATENCY][MAX_PASSES];
+
+    // Averaging window
+    double windowSum[MAX_PASSES];
+    int windowCount[MAX_PASSES];
+    int windowFrames;
+    float average[MAX_PASSES];
+
+    double totalSum[MAX_PASSES];
+    long totalCount[MAX_PASSES];
+};
+
+#endif
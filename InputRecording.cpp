@@ -0,0 +1,306 @@
+#include "InputRecording.h"
+#include <iostream>
+#include <iterator>
+#include <cstring>
+
+static const char MAGIC[4] = { 'K', 'C', 'I', 'R' };
+static const uint32_t FORMAT_VERSION = 1;
+static const size_t TICK_COUNT_OFFSET = 4 + 4 + 8 + 8 * 4 + 4 * 4;
+static const size_t HEADER_SIZE = TICK_COUNT_OFFSET + 4;
+
+// Little-endian encoding helpers
+
+static void putU16(std::vector<unsigned char>& out, uint16_t value) {
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+}
+
+static void putU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+static void putU64(std::vector<unsigned char>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+static void putF32(std::vector<unsigned char>& out, float value) {
+    // Store the exact bits; replays must see the same floats
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    putU32(out, bits);
+}
+
+static void putVarint(std::vector<unsigned char>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static uint16_t getU16(const unsigned char* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const unsigned char* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+static uint64_t getU64(const unsigned char* in) {
+    return static_cast<uint64_t>(getU32(in)) | (static_cast<uint64_t>(getU32(in + 4)) << 32);
+}
+
+static float getF32(const unsigned char* in) {
+    uint32_t bits = getU32(in);
+    float value;
+    std::memcpy(&value, &bits, 4);
+    return value;
+}
+
+static uint16_t packButtons(const InputState& input) {
+    uint16_t bits = 0;
+    if (input.moveUp) bits |= INPUT_MOVE_UP;
+    if (input.moveDown) bits |= INPUT_MOVE_DOWN;
+    if (input.moveLeft) bits |= INPUT_MOVE_LEFT;
+    if (input.moveRight) bits |= INPUT_MOVE_RIGHT;
+    if (input.fireArrow) bits |= INPUT_FIRE_ARROW;
+    if (input.swingSword) bits |= INPUT_SWING_SWORD;
+    if (input.debugDamage) bits |= INPUT_DEBUG_DAMAGE;
+    if (input.debugHeal) bits |= INPUT_DEBUG_HEAL;
+    if (input.debugKill) bits |= INPUT_DEBUG_KILL;
+    return bits;
+}
+
+static void unpackButtons(uint16_t bits, InputState& input) {
+    input.moveUp = (bits & INPUT_MOVE_UP) != 0;
+    input.moveDown = (bits & INPUT_MOVE_DOWN) != 0;
+    input.moveLeft = (bits & INPUT_MOVE_LEFT) != 0;
+    input.moveRight = (bits & INPUT_MOVE_RIGHT) != 0;
+    input.fireArrow = (bits & INPUT_FIRE_ARROW) != 0;
+    input.swingSword = (bits & INPUT_SWING_SWORD) != 0;
+    input.debugDamage = (bits & INPUT_DEBUG_DAMAGE) != 0;
+    input.debugHeal = (bits & INPUT_DEBUG_HEAL) != 0;
+    input.debugKill = (bits & INPUT_DEBUG_KILL) != 0;
+}
+
+static bool sameInput(const InputState& a, const InputState& b) {
+    return packButtons(a) == packButtons(b) &&
+           std::memcmp(&a.aimX, &b.aimX, sizeof(float)) == 0 &&
+           std::memcmp(&a.aimY, &b.aimY, sizeof(float)) == 0;
+}
+
+InputRecorder::InputRecorder()
+    : tickCount(0), pendingRepeat(0), hasLastAim(false), lastAimX(0.0f), lastAimY(0.0f) {
+}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const std::string& path, const SimulationConfig& config) {
+    close();
+
+    file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create input recording: " << path << std::endl;
+        return false;
+    }
+    filePath = path;
+    tickCount = 0;
+    pendingRepeat = 0;
+    hasLastAim = false;
+
+    buffer.clear();
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<unsigned char>(MAGIC[i]));
+    }
+    putU32(buffer, FORMAT_VERSION);
+    putU64(buffer, config.seed);
+    putF32(buffer, config.tickRate);
+    putF32(buffer, config.arenaHalfWidth);
+    putF32(buffer, config.arenaHalfHeight);
+    putF32(buffer, config.baseRadius);
+    putF32(buffer, config.playerSpeed);
+    putF32(buffer, config.enemySpeed);
+    putF32(buffer, config.enemySpawnInterval);
+    putF32(buffer, config.gridCellSize);
+    putU32(buffer, static_cast<uint32_t>(config.initialEnemies));
+    putU32(buffer, static_cast<uint32_t>(config.maxEnemies));
+    putU32(buffer, static_cast<uint32_t>(config.enemiesToKill));
+    putU32(buffer, static_cast<uint32_t>(config.maxProjectiles));
+    putU32(buffer, 0);  // Tick count, filled in by close()
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return true;
+}
+
+void InputRecorder::record(const InputState& input) {
+    if (!file.is_open()) return;
+
+    if (pendingRepeat > 0 && sameInput(input, pending)) {
+        pendingRepeat++;
+    } else {
+        flushRun();
+        pending = input;
+        pendingRepeat = 1;
+    }
+    tickCount++;
+}
+
+void InputRecorder::flushRun() {
+    if (pendingRepeat == 0) return;
+
+    uint16_t buttons = packButtons(pending);
+    bool aimChanged = !hasLastAim ||
+                      std::memcmp(&pending.aimX, &lastAimX, sizeof(float)) != 0 ||
+                      std::memcmp(&pending.aimY, &lastAimY, sizeof(float)) != 0;
+    if (aimChanged) {
+        buttons |= INPUT_AIM_FOLLOWS;
+    }
+
+    buffer.clear();
+    putVarint(buffer, pendingRepeat);
+    putU16(buffer, buttons);
+    if (aimChanged) {
+        putF32(buffer, pending.aimX);
+        putF32(buffer, pending.aimY);
+        lastAimX = pending.aimX;
+        lastAimY = pending.aimY;
+        hasLastAim = true;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    pendingRepeat = 0;
+}
+
+bool InputRecorder::close() {
+    if (!file.is_open()) return true;
+
+    flushRun();
+
+    // Patch the tick count into the header
+    buffer.clear();
+    putU32(buffer, tickCount);
+    file.seekp(static_cast<std::streamoff>(TICK_COUNT_OFFSET));
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+    bool ok = file.good();
+    file.close();
+    if (!ok) {
+        std::cerr << "Failed to write input recording: " << filePath << std::endl;
+    }
+    return ok;
+}
+
+InputReplay::InputReplay()
+    : recordsStart(0), cursor(0), tickCount(0), position(0), remaining(0) {
+}
+
+bool InputReplay::load(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open input recording: " << path << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, 4) != 0) {
+        std::cerr << "Not an input recording: " << path << std::endl;
+        data.clear();
+        return false;
+    }
+    const unsigned char* in = data.data() + 4;
+    uint32_t version = getU32(in);
+    if (version != FORMAT_VERSION) {
+        std::cerr << "Unsupported input recording version " << version << ": " << path << std::endl;
+        data.clear();
+        return false;
+    }
+    in += 4;
+
+    recordedConfig.seed = getU64(in);
+    in += 8;
+    recordedConfig.tickRate = getF32(in);
+    recordedConfig.arenaHalfWidth = getF32(in + 4);
+    recordedConfig.arenaHalfHeight = getF32(in + 8);
+    recordedConfig.baseRadius = getF32(in + 12);
+    recordedConfig.playerSpeed = getF32(in + 16);
+    recordedConfig.enemySpeed = getF32(in + 20);
+    recordedConfig.enemySpawnInterval = getF32(in + 24);
+    recordedConfig.gridCellSize = getF32(in + 28);
+    in += 32;
+    recordedConfig.initialEnemies = static_cast<int>(getU32(in));
+    recordedConfig.maxEnemies = static_cast<int>(getU32(in + 4));
+    recordedConfig.enemiesToKill = static_cast<int>(getU32(in + 8));
+    recordedConfig.maxProjectiles = static_cast<int>(getU32(in + 12));
+    in += 16;
+    tickCount = getU32(in);
+
+    recordsStart = HEADER_SIZE;
+    rewind();
+    return true;
+}
+
+void InputReplay::applyTo(SimulationConfig& config) const {
+    config.seed = recordedConfig.seed;
+    config.tickRate = recordedConfig.tickRate;
+    config.arenaHalfWidth = recordedConfig.arenaHalfWidth;
+    config.arenaHalfHeight = recordedConfig.arenaHalfHeight;
+    config.baseRadius = recordedConfig.baseRadius;
+    config.playerSpeed = recordedConfig.playerSpeed;
+    config.enemySpeed = recordedConfig.enemySpeed;
+    config.enemySpawnInterval = recordedConfig.enemySpawnInterval;
+    config.gridCellSize = recordedConfig.gridCellSize;
+    config.initialEnemies = recordedConfig.initialEnemies;
+    config.maxEnemies = recordedConfig.maxEnemies;
+    config.enemiesToKill = recordedConfig.enemiesToKill;
+    config.maxProjectiles = recordedConfig.maxProjectiles;
+}
+
+void InputReplay::rewind() {
+    cursor = recordsStart;
+    position = 0;
+    remaining = 0;
+    current = InputState();
+}
+
+bool InputReplay::next(InputState& input) {
+    if (position >= tickCount) return false;
+    if (remaining == 0 && !readRecord()) return false;
+
+    input = current;
+    remaining--;
+    position++;
+    return true;
+}
+
+bool InputReplay::readRecord() {
+    // Repeat count (varint)
+    uint32_t repeat = 0;
+    int shift = 0;
+    for (;;) {
+        if (cursor >= data.size() || shift > 28) return false;
+        unsigned char byte = data[cursor++];
+        repeat |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) break;
+        shift += 7;
+    }
+
+    if (cursor + 2 > data.size()) return false;
+    uint16_t buttons = getU16(&data[cursor]);
+    cursor += 2;
+    unpackButtons(buttons, current);
+
+    if (buttons & INPUT_AIM_FOLLOWS) {
+        if (cursor + 8 > data.size()) return false;
+        current.aimX = getF32(&data[cursor]);
+        current.aimY = getF32(&data[cursor + 4]);
+        cursor += 8;
+    }
+
+    remaining = repeat;
+    return repeat > 0;
+}
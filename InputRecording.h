@@ -0,0 +1,106 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "InputState.h"
+#include "Simulation.h"
+
+// Binary input recordings (.kcir): the gameplay settings and seed of a run
+// followed by the InputState of every tick. Replaying a recording into a
+// Simulation built from the same settings reproduces the run exactly.
+//
+// Layout, all values little-endian:
+//   header  "KCIR", u32 version, u64 seed,
+//           f32 tickRate, arenaHalfWidth, arenaHalfHeight, baseRadius,
+//               playerSpeed, enemySpeed, enemySpawnInterval, gridCellSize,
+//           i32 initialEnemies, maxEnemies, enemiesToKill, maxProjectiles,
+//           u32 tickCount
+//   records varint repeat, u16 buttons, [f32 aimX, f32 aimY]
+// A record covers `repeat` identical ticks. Buttons are InputBits flags;
+// the aim is only stored when INPUT_AIM_FOLLOWS is set and otherwise
+// repeats the previous record's aim.
+enum InputBits : uint16_t {
+    INPUT_MOVE_UP      = 1u << 0,
+    INPUT_MOVE_DOWN    = 1u << 1,
+    INPUT_MOVE_LEFT    = 1u << 2,
+    INPUT_MOVE_RIGHT   = 1u << 3,
+    INPUT_FIRE_ARROW   = 1u << 4,
+    INPUT_SWING_SWORD  = 1u << 5,
+    INPUT_DEBUG_DAMAGE = 1u << 6,
+    INPUT_DEBUG_HEAL   = 1u << 7,
+    INPUT_DEBUG_KILL   = 1u << 8,
+    INPUT_AIM_FOLLOWS  = 1u << 15
+};
+
+// Writes one tick of input at a time to a recording file.
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    // Create the file and write the header for a run with this config
+    bool open(const std::string& path, const SimulationConfig& config);
+
+    // Append the input used for the next tick
+    void record(const InputState& input);
+
+    // Flush the last record and finish the header; called by the destructor
+    bool close();
+
+    bool isOpen() const { return file.is_open(); }
+    uint32_t getTickCount() const { return tickCount; }
+
+private:
+    void flushRun();
+
+    std::ofstream file;
+    std::string filePath;
+    uint32_t tickCount;
+
+    // Run of identical ticks not yet written
+    InputState pending;
+    uint32_t pendingRepeat;
+    bool hasLastAim;
+    float lastAimX, lastAimY;
+    std::vector<unsigned char> buffer;
+};
+
+// Loads a recording and hands its inputs back one tick at a time.
+class InputReplay {
+public:
+    InputReplay();
+
+    bool load(const std::string& path);
+
+    // Overwrite the gameplay settings and seed in config with the recorded ones
+    void applyTo(SimulationConfig& config) const;
+
+    // Input for the next tick; false once the recording is exhausted
+    bool next(InputState& input);
+
+    // Start again from the first tick
+    void rewind();
+
+    uint32_t getTickCount() const { return tickCount; }
+    uint32_t getPosition() const { return position; }
+
+private:
+    bool readRecord();
+
+    std::vector<unsigned char> data;
+    size_t recordsStart;
+    size_t cursor;
+    uint32_t tickCount;
+    uint32_t position;   // Ticks handed out so far
+
+    SimulationConfig recordedConfig;
+
+    // Current record
+    InputState current;
+    uint32_t remaining;  // Ticks left in the current record
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+// Snapshot of the player's controls for one simulation step.
+// The simulation only ever sees this struct, so it can be filled from
+// GLFW, a script, or a recording without the simulation knowing which.
+struct InputState {
+    // Movement (WASD)
+    bool moveUp;
+    bool moveDown;
+    bool moveLeft;
+    bool moveRight;
+
+    // Combat
+    bool fireArrow;    // Left mouse button held
+    bool swingSword;   // Right mouse button held
+    float aimX, aimY;  // Cursor position in world coordinates
+
+    // Debug keys
+    bool debugDamage;  // T - damage player every few seconds
+    bool debugHeal;    // H - heal player
+    bool debugKill;    // K - kill player instantly
+
+    InputState()
+        : moveUp(false), moveDown(false), moveLeft(false), moveRight(false),
+          fireArrow(false), swingSword(false), aimX(0.0f), aimY(0.0f),
+          debugDamage(false), debugHeal(false), debugKill(false) {
+    }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem::JobSystem(int workerCount)
+    : invoke(nullptr), context(nullptr), remaining(0), generation(0), stopping(false) {
+    if (workerCount < 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    for (int i = 0; i <= workerCount; i++) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+    for (int i = 1; i <= workerCount; i++) {
+        workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::run(size_t count, size_t grainSize, InvokeFn fn, void* ctx) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    // Small loops, or no workers: not worth waking anybody
+    if (workers.empty() || count <= grainSize) {
+        for (size_t begin = 0; begin < count; begin += grainSize) {
+            fn(ctx, begin, std::min(begin + grainSize, count));
+        }
+        return;
+    }
+
+    invoke = fn;
+    context = ctx;
+
+    // Deal chunks round-robin so every thread starts with local work
+    size_t chunkCount = (count + grainSize - 1) / grainSize;
+    remaining.store(chunkCount);
+    for (std::unique_ptr<Queue>& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->chunks.clear();
+        queue->head = 0;
+        queue->tail = 0;
+    }
+    size_t q = 0;
+    for (size_t begin = 0; begin < count; begin += grainSize) {
+        Queue& queue = *queues[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        Chunk chunk = { begin, std::min(begin + grainSize, count) };
+        queue.chunks.push_back(chunk);
+        queue.tail = queue.chunks.size();
+        q = (q + 1) % queues.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        generation++;
+    }
+    wake.notify_all();
+
+    // Work alongside the pool, then wait for chunks still running elsewhere
+    drain(0);
+    std::unique_lock<std::mutex> lock(signalMutex);
+    finished.wait(lock, [this] { return remaining.load() == 0; });
+}
+
+void JobSystem::workerLoop(int queueIndex) {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(signalMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        drain(queueIndex);
+    }
+}
+
+void JobSystem::drain(int queueIndex) {
+    Chunk chunk;
+    while (popOwn(queueIndex, chunk) || steal(queueIndex, chunk)) {
+        invoke(context, chunk.begin, chunk.end);
+        if (remaining.fetch_sub(1) == 1) {
+            // Last chunk: wake the caller
+            std::lock_guard<std::mutex> lock(signalMutex);
+            finished.notify_all();
+        }
+    }
+}
+
+bool JobSystem::popOwn(int queueIndex, Chunk& chunk) {
+    Queue& queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.head == queue.tail) return false;
+    chunk = queue.chunks[--queue.tail];
+    return true;
+}
+
+bool JobSystem::steal(int thiefIndex, Chunk& chunk) {
+    size_t count = queues.size();
+    for (size_t offset = 1; offset < count; offset++) {
+        Queue& victim = *queues[(thiefIndex + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.head != victim.tail) {
+            chunk = victim.chunks[victim.head++];
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Small work-stealing thread pool for data-parallel loops.
+//
+// parallelFor() cuts a range into chunks and deals them round-robin onto one
+// queue per thread. Each thread drains its own queue from the back and, once
+// empty, steals from the front of the others. The calling thread takes part
+// and the call returns only when every chunk has run. Queues keep their
+// storage between calls, so a steady-state parallelFor does not allocate.
+//
+// Only one thread may call parallelFor at a time, and chunks must not write
+// to shared state; collect such writes per index and merge them afterwards.
+class JobSystem {
+public:
+    // Start the given number of worker threads (0 = run everything on the
+    // calling thread). Negative picks one fewer than the hardware threads.
+    explicit JobSystem(int workerCount);
+    ~JobSystem();
+
+    // Threads that execute chunks, including the caller
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Call body(begin, end) for consecutive sub-ranges of [0, count) of at
+    // most grainSize elements, spread over all threads
+    template <typename Body>
+    void parallelFor(size_t count, size_t grainSize, Body& body) {
+        run(count, grainSize, &invokeBody<Body>, &body);
+    }
+
+private:
+    typedef void (*InvokeFn)(void* context, size_t begin, size_t end);
+
+    template <typename Body>
+    static void invokeBody(void* context, size_t begin, size_t end) {
+        (*static_cast<Body*>(context))(begin, end);
+    }
+
+    struct Chunk {
+        size_t begin, end;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Chunk> chunks;
+        size_t head;  // Next chunk a thief takes
+        size_t tail;  // One past the next chunk the owner takes
+        Queue() : head(0), tail(0) {}
+    };
+
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+
+    void run(size_t count, size_t grainSize, InvokeFn fn, void* context);
+    void workerLoop(int queueIndex);
+    void drain(int queueIndex);
+    bool popOwn(int queueIndex, Chunk& chunk);
+    bool steal(int thiefIndex, Chunk& chunk);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;  // queues[0] belongs to the caller
+
+    // Current loop
+    InvokeFn invoke;
+    void* context;
+    std::atomic<size_t> remaining;
+
+    // Wake-up and completion signalling
+    std::mutex signalMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned long generation;
+    bool stopping;
+};
+
+#endif
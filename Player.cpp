@@ -2,29 +2,29 @@
 #include <cmath>
 
 Player::Player(float startX, float startY, float rad, float spd)
-    : x(startX), y(startY), radius(rad), speed(spd),
+    : x(startX), y(startY), prevX(startX), prevY(startY), radius(rad), speed(spd),
       maxHealth(100), currentHealth(100), isInvulnerable(false),
       invulnerabilityTimer(0.0f), invulnerabilityDuration(1.0f),
-      isDead(false), timeOfDeath(0.0f),
-      collisionRadius(rad * 1.1f), pushForce(0.015f) {
+      isDead(false), timeOfDeath(0.0),
+      collisionRadius(rad * 1.1f), pushForce(0.9f) {
 }
 
-void Player::update(GLFWwindow* window, float deltaTime) {
+void Player::update(const InputState& input, float deltaTime) {
     // Don't process input if player is dead
     if (isDead) {
         return;
     }
     
     // Calculate movement based on deltaTime for consistent speed
-    float adjustedSpeed = speed * deltaTime * 60.0f; // Scale for 60fps equivalent
+    float adjustedSpeed = speed * deltaTime;
     
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    if (input.moveUp)
         y += adjustedSpeed;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    if (input.moveDown)
         y -= adjustedSpeed;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    if (input.moveLeft)
         x -= adjustedSpeed;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    if (input.moveRight)
         x += adjustedSpeed;
         
     // Update invulnerability timer
@@ -72,7 +72,7 @@ float Player::getHealthPercentage() const {
 void Player::die() {
     isDead = true;
     currentHealth = 0;
-    timeOfDeath = static_cast<float>(glfwGetTime()); // Record time of death for the death timer
+    // timeOfDeath is stamped by the Simulation, which owns the clock
 }
 
 void Player::handleCollision(float otherX, float otherY, float otherRadius, float deltaTime) {
@@ -93,7 +93,7 @@ void Player::handleCollision(float otherX, float otherY, float otherRadius, floa
             float overlap = (collisionRadius + otherRadius) - dist;
             
             // Push player away
-            float pushDistance = overlap * 0.5f + pushForce;
+            float pushDistance = overlap * 0.5f + pushForce * deltaTime;
             x += dx * pushDistance;
             y += dy * pushDistance;
         }
@@ -1,28 +1,29 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include "dependente/glfw/glfw3.h"
+#include "InputState.h"
 
 class Player {
 public:
     float x, y;
+    float prevX, prevY;        // Position at the start of the current tick (for interpolation)
     float radius;
-    float speed;
+    float speed;               // Movement speed in world units per second
     int maxHealth;
     int currentHealth;
     bool isInvulnerable;
     float invulnerabilityTimer;
     float invulnerabilityDuration;
     bool isDead;
-    float timeOfDeath;
+    double timeOfDeath;        // Simulation time at which the player died
     
     // Collision properties
     float collisionRadius;
-    float pushForce;
+    float pushForce;           // Extra separation per second applied during collisions
 
     // Constructor: starting position, radius, and speed.
     Player(float startX, float startY, float rad, float spd);
-    void update(GLFWwindow* window, float deltaTime);
+    void update(const InputState& input, float deltaTime);
     void takeDamage(int amount);
     void heal(int amount);
     float getHealthPercentage() const;
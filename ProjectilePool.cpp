@@ -0,0 +1,88 @@
+#include "ProjectilePool.h"
+
+const size_t ProjectilePool::npos;
+const uint32_t ProjectilePool::NO_OWNER;
+
+ProjectilePool::ProjectilePool()
+    : freeCount(0), used(0), dropped(0) {
+}
+
+void ProjectilePool::init(size_t capacity) {
+    x.assign(capacity, 0.0f);
+    y.assign(capacity, 0.0f);
+    prevX.assign(capacity, 0.0f);
+    prevY.assign(capacity, 0.0f);
+    vx.assign(capacity, 0.0f);
+    vy.assign(capacity, 0.0f);
+    radius.assign(capacity, 0.0f);
+    damage.assign(capacity, 0);
+    faction.assign(capacity, FACTION_PLAYER);
+    owner.assign(capacity, NO_OWNER);
+    active.assign(capacity, 0);
+    freeList.assign(capacity, 0);
+
+    clear();
+}
+
+void ProjectilePool::clear() {
+    for (size_t i = 0; i < used; i++) {
+        active[i] = 0;
+    }
+    freeCount = 0;
+    used = 0;
+    dropped = 0;
+}
+
+size_t ProjectilePool::spawn(float startX, float startY, float velX, float velY, float rad,
+                             int dmg, Faction side, uint32_t ownerSlot) {
+    // Prefer a recycled slot so the active range stays compact
+    size_t i;
+    if (freeCount > 0) {
+        i = freeList[--freeCount];
+    } else if (used < active.size()) {
+        i = used++;
+    } else {
+        dropped++;
+        return npos;
+    }
+
+    x[i] = startX;
+    y[i] = startY;
+    prevX[i] = startX;
+    prevY[i] = startY;
+    vx[i] = velX;
+    vy[i] = velY;
+    radius[i] = rad;
+    damage[i] = dmg;
+    faction[i] = side;
+    owner[i] = ownerSlot;
+    active[i] = 1;
+    return i;
+}
+
+void ProjectilePool::kill(size_t i) {
+    if (!active[i]) return;
+    active[i] = 0;
+    freeList[freeCount++] = static_cast<uint32_t>(i);
+}
+
+void ProjectilePool::integrate(float deltaTime) {
+    for (size_t i = 0; i < used; i++) {
+        if (!active[i]) continue;
+
+        prevX[i] = x[i];
+        prevY[i] = y[i];
+        x[i] += vx[i] * deltaTime;
+        y[i] += vy[i] * deltaTime;
+    }
+}
+
+void ProjectilePool::cullOutside(float minX, float minY, float maxX, float maxY) {
+    for (size_t i = 0; i < used; i++) {
+        if (!active[i]) continue;
+
+        if (x[i] < minX || x[i] > maxX || y[i] < minY || y[i] > maxY) {
+            kill(i);
+        }
+    }
+}
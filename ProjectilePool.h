@@ -0,0 +1,71 @@
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Which side fired a projectile; decides what it can hit
+enum Faction : unsigned char {
+    FACTION_PLAYER,
+    FACTION_ENEMY
+};
+
+// Structure-of-arrays storage for every arrow in flight, player and enemy.
+//
+// The pool is allocated once with a fixed capacity. Slots are recycled
+// through a free list, so spawning and removing never touch the heap.
+// Slots [0, highWater()) have been used at least once; integrate() and
+// cullOutside() walk only that range and skip inactive slots.
+class ProjectilePool {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+    static const uint32_t NO_OWNER = 0xFFFFFFFFu;
+
+    ProjectilePool();
+
+    // Allocate storage for the given number of projectiles and clear the pool
+    void init(size_t capacity);
+
+    // Deactivate every projectile
+    void clear();
+
+    // Launch a projectile; returns its slot, or npos if the pool is full
+    size_t spawn(float x, float y, float vx, float vy, float radius,
+                 int damage, Faction faction, uint32_t owner);
+
+    // Deactivate the projectile in slot i and return the slot to the free list
+    void kill(size_t i);
+
+    // Move every active projectile by one step. Also records the previous
+    // position used for interpolation and swept hit tests.
+    void integrate(float deltaTime);
+
+    // Kill every active projectile whose center lies outside the box
+    // [minX, maxX] x [minY, maxY]. Run after hits along the path travelled
+    // this tick are resolved, so an arrow that hits and leaves still counts.
+    void cullOutside(float minX, float minY, float maxX, float maxY);
+
+    size_t capacity() const { return active.size(); }
+    size_t highWater() const { return used; }
+    size_t activeCount() const { return used - freeCount; }
+    size_t droppedCount() const { return dropped; }  // Spawns refused because the pool was full
+
+    // Per-slot data, valid where active[i] != 0
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY;   // Position at the start of the current tick
+    std::vector<float> vx, vy;         // Velocity in world units per second
+    std::vector<float> radius;
+    std::vector<int> damage;
+    std::vector<unsigned char> faction;  // Faction
+    std::vector<uint32_t> owner;         // Enemy slot (EnemyHandle::slot) or NO_OWNER
+    std::vector<unsigned char> active;
+
+private:
+    std::vector<uint32_t> freeList;  // Released slots below highWater(), used as a stack
+    size_t freeCount;
+    size_t used;
+    size_t dropped;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "QuadBatch.h"
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+const size_t QuadBatch::QUAD_BYTES = 4 * sizeof(QuadBatch::Vertex);
+
+QuadBatch::QuadBatch()
+    : shader(0), VAO(0), EBO(0), whiteTexture(0), queue(nullptr), arena(nullptr),
+      maxQuads(0), frameQuads(0), overflowReported(false),
+      currentTexture(0), currentLayer(RENDER_HUD) {
+}
+
+QuadBatch::~QuadBatch() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+    }
+    if (EBO) {
+        glDeleteBuffers(1, &EBO);
+    }
+    if (whiteTexture) {
+        glDeleteTextures(1, &whiteTexture);
+    }
+}
+
+bool QuadBatch::init(GLuint shaderProgram, size_t quadCapacity, RenderQueue* renderQueue, StreamArena* streamArena) {
+    if (!shaderProgram || quadCapacity == 0 || !renderQueue || !streamArena) {
+        std::cerr << "QuadBatch needs a shader, a render queue, a stream arena and a non-zero capacity" << std::endl;
+        return false;
+    }
+    shader = shaderProgram;
+    queue = renderQueue;
+    arena = streamArena;
+    maxQuads = quadCapacity;
+    vertices.reserve(maxQuads * 4);
+
+    glUseProgram(shader);
+    glUniform1i(glGetUniformLocation(shader, "uTexture"), 0);
+
+    // Solid quads sample a single white texel, so every quad uses one shader path
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+    glGenTextures(1, &whiteTexture);
+    glBindTexture(GL_TEXTURE_2D, whiteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Every quad is two triangles over its four vertices
+    std::vector<GLuint> indices(maxQuads * 6);
+    for (size_t q = 0; q < maxQuads; q++) {
+        GLuint base = static_cast<GLuint>(q * 4);
+        indices[q * 6 + 0] = base + 0;
+        indices[q * 6 + 1] = base + 1;
+        indices[q * 6 + 2] = base + 2;
+        indices[q * 6 + 3] = base + 0;
+        indices[q * 6 + 4] = base + 2;
+        indices[q * 6 + 5] = base + 3;
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+
+    // Vertices live in the arena; each batch picks its base vertex
+    glBindBuffer(GL_ARRAY_BUFFER, arena->buffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    GLsizei stride = sizeof(Vertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, r));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, edge));
+    glEnableVertexAttribArray(3);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void QuadBatch::begin() {
+    vertices.clear();
+    frameQuads = 0;
+}
+
+void QuadBatch::setLayer(RenderLayer layer) {
+    if (layer != currentLayer) {
+        flush();
+        currentLayer = layer;
+    }
+}
+
+void QuadBatch::addQuad(float x, float y, float width, float height, const glm::vec4& color, float fill) {
+    if (fill <= 0.0f) return;  // Nothing visible
+    push(x, y, width, height, whiteTexture, 0.0f, 0.0f, 1.0f, 1.0f, color, fill);
+}
+
+void QuadBatch::addTexturedQuad(float x, float y, float width, float height, GLuint texture,
+                                float u0, float v0, float u1, float v1, const glm::vec4& color) {
+    push(x, y, width, height, texture, u0, v0, u1, v1, color, 1.0f);
+}
+
+void QuadBatch::push(float x, float y, float width, float height, GLuint texture,
+                     float u0, float v0, float u1, float v1, const glm::vec4& color, float fill) {
+    if (!VAO) return;
+
+    // A new material ends the current batch
+    if (!vertices.empty() && texture != currentTexture) {
+        flush();
+    }
+    currentTexture = texture;
+
+    // Keep the frame within the space the arena was sized for; drop what
+    // does not fit
+    if (frameQuads + vertices.size() / 4 + 1 > maxQuads) {
+        if (!overflowReported) {
+            std::cerr << "QuadBatch full (" << maxQuads << " quads per frame); dropping quads" << std::endl;
+            overflowReported = true;
+        }
+        return;
+    }
+
+    Vertex corner;
+    corner.r = color.r;
+    corner.g = color.g;
+    corner.b = color.b;
+    corner.a = color.a;
+    corner.fill = fill;
+
+    // Bottom left, bottom right, top right, top left
+    corner.x = x;         corner.y = y;          corner.u = u0; corner.v = v0; corner.edge = 0.0f;
+    vertices.push_back(corner);
+    corner.x = x + width; corner.y = y;          corner.u = u1; corner.v = v0; corner.edge = 1.0f;
+    vertices.push_back(corner);
+    corner.x = x + width; corner.y = y + height; corner.u = u1; corner.v = v1; corner.edge = 1.0f;
+    vertices.push_back(corner);
+    corner.x = x;         corner.y = y + height; corner.u = u0; corner.v = v1; corner.edge = 0.0f;
+    vertices.push_back(corner);
+}
+
+void QuadBatch::flush() {
+    if (vertices.empty()) return;
+
+    // Aligned to whole vertices so the offset is a base vertex
+    size_t quadCount = vertices.size() / 4;
+    StreamAllocation allocation = arena->allocate(vertices.size() * sizeof(Vertex), sizeof(Vertex));
+    if (!allocation.data) {
+        vertices.clear();
+        return;
+    }
+    std::memcpy(allocation.data, vertices.data(), allocation.size);
+    arena->commit(allocation);
+
+    DrawCommand& command = queue->add(currentLayer, shader, VAO, currentTexture);
+    command.blend = true;
+    command.indexed = true;
+    command.count = static_cast<GLsizei>(quadCount * 6);
+    command.baseVertex = static_cast<GLint>(allocation.offset / sizeof(Vertex));
+
+    frameQuads += quadCount;
+    vertices.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef QUAD_BATCH_H
+#define QUAD_BATCH_H
+
+#include <vector>
+#include "RenderQueue.h"
+#include "StreamArena.h"
+#include "dependente/glew/glew.h"
+#include "dependente/glm/glm.hpp"
+
+// Collects axis-aligned quads (overlays, graph bars, textured sprites) into
+// the frame's stream arena and turns them into as few draws as possible:
+// a batch only ends when the material (texture) or layer changes, or on
+// flush(). Each batch is copied into its own arena allocation and queued
+// as one indexed draw in the render queue.
+class QuadBatch {
+public:
+    QuadBatch();
+    ~QuadBatch();
+
+    // Create the buffers; shaderProgram is built from quad_vertex.glsl and
+    // quad_fragment.glsl. quadCapacity is the most quads one frame can hold;
+    // the arena needs QUAD_BYTES for each of them.
+    bool init(GLuint shaderProgram, size_t quadCapacity, RenderQueue* renderQueue, StreamArena* streamArena);
+
+    // Start a new frame (after the arena's beginFrame)
+    void begin();
+
+    // Layer for the quads added from now on
+    void setLayer(RenderLayer layer);
+
+    // Solid quad with its bottom-left corner at (x, y). Only the left `fill`
+    // fraction of it is drawn, so a bar of the GPU times graph is one quad
+    // whose fill is its share of the full scale.
+    void addQuad(float x, float y, float width, float height, const glm::vec4& color, float fill = 1.0f);
+
+    // Quad showing the [u0,u1] x [v0,v1] region of texture, tinted by color
+    void addTexturedQuad(float x, float y, float width, float height, GLuint texture,
+                         float u0, float v0, float u1, float v1, const glm::vec4& color);
+
+    // Upload the pending quads and queue their draw
+    void flush();
+
+    // Arena bytes one quad needs, not counting alignment
+    static const size_t QUAD_BYTES;
+
+private:
+    struct Vertex {
+        float x, y;
+        float u, v;
+        float r, g, b, a;
+        float edge, fill;   // Position across the quad (0..1) and visible fraction
+    };
+
+    void push(float x, float y, float width, float height, GLuint texture,
+              float u0, float v0, float u1, float v1, const glm::vec4& color, float fill);
+
+    GLuint shader;
+    GLuint VAO, EBO;
+    GLuint whiteTexture;            // Material of solid quads
+    RenderQueue* queue;
+    StreamArena* arena;
+    size_t maxQuads;
+    size_t frameQuads;              // Quads already uploaded this frame
+    bool overflowReported;
+
+    std::vector<Vertex> vertices;   // Pending quads, four vertices each
+    GLuint currentTexture;          // Material of the pending quads
+    RenderLayer currentLayer;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "Random.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RANDOM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const float FLOAT_SCALE = 1.0f / 16777216.0f;  // 2^-24
+
+static uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+uint64_t deriveSeed(uint64_t seed, uint64_t stream) {
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ull);
+    splitmix64(state);
+    return splitmix64(state);
+}
+
+Rng::Rng() {
+    seed(0);
+}
+
+Rng::Rng(uint64_t value) {
+    seed(value);
+}
+
+void Rng::seed(uint64_t value) {
+    // Expand the seed with splitmix64; the state must not be all zero
+    uint64_t state = value;
+    uint64_t a = splitmix64(state);
+    uint64_t b = splitmix64(state);
+    s[0] = static_cast<uint32_t>(a);
+    s[1] = static_cast<uint32_t>(a >> 32);
+    s[2] = static_cast<uint32_t>(b);
+    s[3] = static_cast<uint32_t>(b >> 32);
+    if ((s[0] | s[1] | s[2] | s[3]) == 0) {
+        s[0] = 1;
+    }
+}
+
+uint32_t Rng::nextU32() {
+    uint32_t result = s[0] + s[3];
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+
+    return result;
+}
+
+float Rng::nextFloat() {
+    // The low bits of xoshiro128+ are weak; use the top 24
+    return static_cast<float>(nextU32() >> 8) * FLOAT_SCALE;
+}
+
+float Rng::range(float min, float max) {
+    return min + nextFloat() * (max - min);
+}
+
+uint32_t Rng::below(uint32_t bound) {
+    // Multiply-shift maps 32 random bits onto [0, bound)
+    return static_cast<uint32_t>((static_cast<uint64_t>(nextU32()) * bound) >> 32);
+}
+
+void Rng::fill(float* out, size_t count, float min, float max) {
+    // Four lane generators, stored as lane[word][lane]
+    uint32_t lane[4][4];
+    for (int l = 0; l < 4; l++) {
+        Rng seeded((static_cast<uint64_t>(nextU32()) << 32) | nextU32());
+        for (int w = 0; w < 4; w++) {
+            lane[w][l] = seeded.s[w];
+        }
+    }
+
+    float span = max - min;
+    size_t i = 0;
+
+#if defined(RANDOM_SSE2)
+    __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane[0]));
+    __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane[1]));
+    __m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane[2]));
+    __m128i s3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane[3]));
+    const __m128 scale = _mm_set1_ps(FLOAT_SCALE);
+    const __m128 vmin = _mm_set1_ps(min);
+    const __m128 vspan = _mm_set1_ps(span);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i result = _mm_add_epi32(s0, s3);
+        __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+        __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale);
+        _mm_storeu_ps(out + i, _mm_add_ps(vmin, _mm_mul_ps(unit, vspan)));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lane[0]), s0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lane[1]), s1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lane[2]), s2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lane[3]), s3);
+#endif
+
+    // Scalar lanes: the whole range without SSE2, otherwise the tail
+    for (; i < count; i++) {
+        int l = static_cast<int>(i & 3);
+        uint32_t result = lane[0][l] + lane[3][l];
+        uint32_t t = lane[1][l] << 9;
+        lane[2][l] ^= lane[0][l];
+        lane[3][l] ^= lane[1][l];
+        lane[1][l] ^= lane[2][l];
+        lane[0][l] ^= lane[3][l];
+        lane[2][l] ^= t;
+        lane[3][l] = rotl(lane[3][l], 11);
+
+        float unit = static_cast<float>(result >> 8) * FLOAT_SCALE;
+        out[i] = min + unit * span;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Independent random streams derived from one game seed. Each consumer owns
+// its own generator, so the numbers one system draws never depend on how
+// many another system drew (or on which thread it ran).
+enum RandomStream : uint64_t {
+    STREAM_SPAWN      = 1,       // Enemy spawn positions
+    STREAM_TERRAIN    = 2,       // Background terrain layout
+    STREAM_ENEMY_BASE = 0x1000   // + spawn serial: per-enemy AI stream
+};
+
+// Seed for the given stream of a game seed (splitmix64 of both)
+uint64_t deriveSeed(uint64_t seed, uint64_t stream);
+
+// xoshiro128+ generator: 16 bytes of state, a few adds/xors/shifts per
+// number, explicitly seeded. Not thread-safe; give each thread or entity
+// its own instance.
+class Rng {
+public:
+    Rng();
+    explicit Rng(uint64_t seed);
+
+    void seed(uint64_t seed);
+
+    uint32_t nextU32();
+
+    // Uniform float in [0, 1) with 24 bits of precision
+    float nextFloat();
+
+    // Uniform float in [min, max)
+    float range(float min, float max);
+
+    // Uniform integer in [0, bound)
+    uint32_t below(uint32_t bound);
+
+    // Fill out[0 .. count) with uniform floats in [min, max). Runs four
+    // generators side by side (SSE2 where available, otherwise the same
+    // math in plain C++), seeded from this one, so the output is identical
+    // on every platform. Advances this generator by a fixed amount.
+    void fill(float* out, size_t count, float min, float max);
+
+private:
+    uint32_t s[4];
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "RenderQueue.h"
+#include "GpuProfiler.h"
+#include <algorithm>
+#include <cstring>
+
+static const GLuint UNKNOWN_BINDING = 0xFFFFFFFFu;
+
+static const int LAYER_SHIFT = 56;
+static const int PROGRAM_SHIFT = 44;
+static const int VAO_SHIFT = 32;
+static const int TEXTURE_SHIFT = 20;
+static const uint64_t ID_MASK = 0xFFF;       // 12 bits per GL name
+static const uint64_t DEPTH_MASK = 0xFFFFF;  // 20 bits of submission order
+
+// Layers whose draws may be reordered by state; everything else is drawn
+// in submission order
+static bool sortsByState(RenderLayer layer) {
+    return layer == RENDER_TERRAIN || layer == RENDER_WEAPONS;
+}
+
+GLStateCache::GLStateCache() {
+    invalidate();
+}
+
+void GLStateCache::invalidate() {
+    program = UNKNOWN_BINDING;
+    vao = UNKNOWN_BINDING;
+    texture = UNKNOWN_BINDING;
+    blend = -1;
+}
+
+void GLStateCache::useProgram(GLuint id) {
+    if (program == id) return;
+    glUseProgram(id);
+    program = id;
+}
+
+void GLStateCache::bindVertexArray(GLuint id) {
+    if (vao == id) return;
+    glBindVertexArray(id);
+    vao = id;
+}
+
+void GLStateCache::bindTexture(GLuint id) {
+    if (texture == id) return;
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+    texture = id;
+}
+
+void GLStateCache::setBlend(bool enabled) {
+    int wanted = enabled ? 1 : 0;
+    if (blend == wanted) return;
+    if (enabled) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        glDisable(GL_BLEND);
+    }
+    blend = wanted;
+}
+
+DrawCommand::DrawCommand()
+    : program(0), vao(0), texture(0), blend(false),
+      mode(GL_TRIANGLES), first(0), count(0), indexed(false), baseVertex(0),
+      modelLocation(-1) {
+}
+
+void DrawCommand::setModel(GLint location, const float* matrix) {
+    modelLocation = location;
+    std::memcpy(model, matrix, sizeof(model));
+}
+
+RenderQueue::RenderQueue() : sequence(0) {
+}
+
+DrawCommand& RenderQueue::add(RenderLayer layer, GLuint program, GLuint vao, GLuint texture) {
+    SortEntry entry;
+    entry.key = (static_cast<uint64_t>(layer) << LAYER_SHIFT) | (sequence & DEPTH_MASK);
+    if (sortsByState(layer)) {
+        entry.key |= ((program & ID_MASK) << PROGRAM_SHIFT) |
+                     ((vao & ID_MASK) << VAO_SHIFT) |
+                     ((texture & ID_MASK) << TEXTURE_SHIFT);
+    }
+    entry.index = static_cast<uint32_t>(commands.size());
+    order.push_back(entry);
+    sequence++;
+
+    commands.push_back(DrawCommand());
+    DrawCommand& command = commands.back();
+    command.program = program;
+    command.vao = vao;
+    command.texture = texture;
+    return command;
+}
+
+void RenderQueue::submit(GLStateCache& state, GpuProfiler* profiler) {
+    std::sort(order.begin(), order.end());
+
+    int currentLayer = -1;
+    for (size_t i = 0; i < order.size(); i++) {
+        const DrawCommand& command = commands[order[i].index];
+
+        int layer = static_cast<int>(order[i].key >> LAYER_SHIFT);
+        if (profiler && layer != currentLayer) {
+            profiler->beginPass(layer);
+            currentLayer = layer;
+        }
+
+        state.useProgram(command.program);
+        state.bindVertexArray(command.vao);
+        if (command.texture) {
+            state.bindTexture(command.texture);
+        }
+        state.setBlend(command.blend);
+
+        if (command.modelLocation >= 0) {
+            glUniformMatrix4fv(command.modelLocation, 1, GL_FALSE, command.model);
+        }
+
+        if (command.indexed) {
+            void* offset = reinterpret_cast<void*>(static_cast<size_t>(command.first) * sizeof(GLuint));
+            glDrawElementsBaseVertex(command.mode, command.count, GL_UNSIGNED_INT, offset, command.baseVertex);
+        } else {
+            glDrawArrays(command.mode, command.first, command.count);
+        }
+    }
+
+    if (profiler) {
+        profiler->endPass();
+    }
+
+    // Leave no VAO bound for code that sets up buffers directly
+    state.bindVertexArray(0);
+
+    commands.clear();
+    order.clear();
+    sequence = 0;
+}
@@ -0,0 +1,102 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include "dependente/glew/glew.h"
+
+class GpuProfiler;
+
+// Draw order, most significant part of the sort key. Everything in a layer
+// is drawn before anything in the next one.
+enum RenderLayer : uint8_t {
+    RENDER_TERRAIN = 0,
+    RENDER_ENTITIES,
+    RENDER_WEAPONS,
+    RENDER_HUD,
+    RENDER_OVERLAY,
+    RENDER_LAYER_COUNT
+};
+
+// Remembers the GL state the render queue last set and skips binds that
+// would not change anything. Call invalidate() after code that talks to GL
+// directly (text rendering, initialization).
+class GLStateCache {
+public:
+    GLStateCache();
+
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindTexture(GLuint texture);   // GL_TEXTURE_2D on unit 0
+    void setBlend(bool enabled);
+
+private:
+    GLuint program;
+    GLuint vao;
+    GLuint texture;
+    int blend;   // -1 = unknown
+};
+
+// One draw call and the model matrix it needs. A model location of -1 is
+// skipped.
+struct DrawCommand {
+    GLuint program;
+    GLuint vao;
+    GLuint texture;       // 0 = none
+    bool blend;
+
+    GLenum mode;
+    GLint first;          // First vertex, or first index when indexed
+    GLsizei count;        // Vertices or indices
+    bool indexed;         // GL_UNSIGNED_INT indices from the VAO's element buffer
+    GLint baseVertex;     // Added to every index
+
+    GLint modelLocation;
+    float model[16];
+
+    DrawCommand();
+    void setModel(GLint location, const float* matrix);
+};
+
+// Collects a frame's draw commands and submits them sorted by a 64-bit key.
+// In layers whose draws do not depend on each other's order (terrain,
+// weapons) the key groups draws by state:
+//
+//   bits 56-63  layer
+//   bits 44-55  shader program
+//   bits 32-43  vertex array
+//   bits 20-31  texture
+//   bits  0-19  depth (submission order)
+//
+// so draws sharing a program, VAO and texture end up next to each other
+// and only the first of them binds anything. There is no depth test, so in
+// the other layers (blended shapes, HUD, overlays) submission order is the
+// back-to-front order and the key is the layer followed by the depth alone.
+class RenderQueue {
+public:
+    RenderQueue();
+
+    // Append a command; the returned reference is valid until the next add()
+    DrawCommand& add(RenderLayer layer, GLuint program, GLuint vao, GLuint texture);
+
+    // Sort, draw everything through the state cache and empty the queue.
+    // With a profiler, each layer is timed as the pass of the same number.
+    void submit(GLStateCache& state, GpuProfiler* profiler = nullptr);
+
+    size_t size() const { return commands.size(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+        bool operator<(const SortEntry& other) const { return key < other.key; }
+    };
+
+    std::vector<DrawCommand> commands;
+    std::vector<SortEntry> order;
+    uint32_t sequence;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "RenderSnapshot.h"
+#include <algorithm>
+#include <utility>
+
+RenderSnapshot::RenderSnapshot()
+    : player(0.0f, 0.0f, 0.0f, 0.0f), sword(), time(0.0f), kills(0), killTarget(0), gameWon(false),
+      alpha(1.0f), capturedAt(0.0), tickDuration(1.0f) {
+}
+
+float RenderSnapshot::alphaAt(double now) const {
+    float blend = alpha + static_cast<float>(now - capturedAt) / tickDuration;
+    return std::min(std::max(blend, 0.0f), 1.0f);
+}
+
+void captureSnapshot(const Simulation& sim, RenderSnapshot& out) {
+    out.player = sim.player;
+    out.sword = sim.sword;
+    out.time = sim.time;
+    out.kills = sim.totalEnemiesKilled;
+    out.killTarget = sim.enemiesToKill;
+    out.gameWon = sim.gameWon;
+    out.tickDuration = sim.getTickDuration();
+
+    const EnemyPool& enemies = sim.enemies;
+    out.enemies.clear();
+    for (size_t i = 0; i < enemies.size(); i++) {
+        if (enemies.isDead(i)) continue;
+        RenderSnapshot::Enemy enemy;
+        enemy.prevX = enemies.prevX[i];
+        enemy.prevY = enemies.prevY[i];
+        enemy.x = enemies.x[i];
+        enemy.y = enemies.y[i];
+        enemy.radius = enemies.radius[i];
+        enemy.health = enemies.getHealthPercentage(i);
+        enemy.state = enemies.state[i];
+        out.enemies.push_back(enemy);
+    }
+
+    const ProjectilePool& projectiles = sim.projectiles;
+    out.projectiles.clear();
+    for (size_t p = 0; p < projectiles.highWater(); p++) {
+        if (!projectiles.active[p]) continue;
+        RenderSnapshot::Projectile projectile;
+        projectile.prevX = projectiles.prevX[p];
+        projectile.prevY = projectiles.prevY[p];
+        projectile.x = projectiles.x[p];
+        projectile.y = projectiles.y[p];
+        projectile.vx = projectiles.vx[p];
+        projectile.vy = projectiles.vy[p];
+        projectile.radius = projectiles.radius[p];
+        projectile.faction = projectiles.faction[p];
+        out.projectiles.push_back(projectile);
+    }
+}
+
+SnapshotBuffer::SnapshotBuffer()
+    : writeIndex(0), readyIndex(1), readIndex(2), published(false), started(false), stopped(false) {
+}
+
+void SnapshotBuffer::publish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(writeIndex, readyIndex);
+        published = true;
+        started = true;
+    }
+    ready.notify_one();
+}
+
+const RenderSnapshot* SnapshotBuffer::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this] { return started || stopped; });
+    if (stopped) {
+        return nullptr;
+    }
+    if (published) {
+        std::swap(readIndex, readyIndex);
+        published = false;
+    }
+    return &slots[readIndex];
+}
+
+void SnapshotBuffer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    ready.notify_all();
+}
@@ -0,0 +1,86 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "Simulation.h"
+
+// Everything the renderer reads from the simulation, copied out after a
+// batch of ticks so drawing never touches the live simulation. Positions
+// keep the previous tick's value for interpolation.
+struct RenderSnapshot {
+    struct Enemy {
+        float prevX, prevY, x, y;
+        float radius;
+        float health;              // Fraction of full health (0..1)
+        unsigned char state;       // Enemy::AIState
+    };
+
+    struct Projectile {
+        float prevX, prevY, x, y;
+        float vx, vy;
+        float radius;
+        unsigned char faction;     // Faction
+    };
+
+    Player player;
+    Simulation::Sword sword;
+    std::vector<Enemy> enemies;            // Living enemies only
+    std::vector<Projectile> projectiles;   // Active projectiles only
+    double time;               // Simulation clock
+    int kills;
+    int killTarget;            // Kills needed to win
+    bool gameWon;
+
+    // Interpolation: alpha was the blend factor at wall-clock capturedAt;
+    // it grows by one per tickDuration after that
+    float alpha;
+    double capturedAt;
+    float tickDuration;
+
+    RenderSnapshot();
+
+    // Blend factor at wall-clock time now, clamped to the current tick
+    float alphaAt(double now) const;
+};
+
+// Copy the renderable state of sim. The vectors keep their capacity, so a
+// reused snapshot stops allocating once it has seen the largest frame.
+void captureSnapshot(const Simulation& sim, RenderSnapshot& out);
+
+// Triple buffer between one producer (the simulation thread) and one
+// consumer (the render thread). The producer always has a slot of its own
+// to fill, so publishing never waits for the renderer; the consumer always
+// gets the newest published snapshot and skips any it was too slow for.
+class SnapshotBuffer {
+public:
+    SnapshotBuffer();
+
+    // Producer: the slot to fill next, then publish() it
+    RenderSnapshot& writeSlot() { return slots[writeIndex]; }
+    void publish();
+
+    // Consumer: the newest snapshot, which stays valid until the next
+    // acquire(). Waits only until the first one is published; null once
+    // stop() has been called.
+    const RenderSnapshot* acquire();
+
+    // Wake the consumer and make acquire() return null from now on
+    void stop();
+
+private:
+    static const int SLOTS = 3;
+
+    RenderSnapshot slots[SLOTS];
+    int writeIndex;            // Owned by the producer
+    int readyIndex;            // Newest published, owned by neither
+    int readIndex;             // Owned by the consumer
+    bool published;            // readyIndex holds a snapshot the consumer has not taken
+    bool started;              // Something has been published
+    bool stopped;
+    std::mutex mutex;
+    std::condition_variable ready;
+};
+
+#endif
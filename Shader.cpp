@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     std::string vertexCode;
@@ -62,6 +63,64 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    reflect();
+}
+
+void Shader::reflect() {
+    uniforms.clear();
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(maxLength > 0 ? maxLength : 1);
+
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+
+        // Members of uniform blocks have no location
+        GLint location = glGetUniformLocation(ID, name.data());
+        if (location < 0) continue;
+
+        // Arrays are reported as "name[0]"; store them under "name"
+        std::string key(name.data(), length);
+        if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0) {
+            key.erase(key.size() - 3);
+        }
+        UniformInfo info = { location, type };
+        uniforms[key] = info;
+    }
+
+    GLuint frameBlock = glGetUniformBlockIndex(ID, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(ID, frameBlock, FRAME_DATA_BINDING);
+    }
+}
+
+GLint Shader::locationOf(const std::string& name) const {
+    std::map<std::string, UniformInfo>::const_iterator it = uniforms.find(name);
+    return it != uniforms.end() ? it->second.location : -1;
+}
+
+GLint Shader::resolve(const char* name, GLenum type) const {
+    std::map<std::string, UniformInfo>::const_iterator it = uniforms.find(name);
+    if (it == uniforms.end()) {
+        // Unused uniforms are optimized out by the compiler, so this is not fatal
+        std::cerr << "Shader " << ID << " has no active uniform " << name << std::endl;
+        return -1;
+    }
+
+    GLenum actual = it->second.type;
+    bool integer = actual == GL_INT || actual == GL_BOOL || actual == GL_SAMPLER_2D || actual == GL_SAMPLER_2D_ARRAY;
+    if (actual != type && !(type == GL_INT && integer)) {
+        std::cerr << "Shader " << ID << " uniform " << name << " has a different type" << std::endl;
+        return -1;
+    }
+    return it->second.location;
 }
 
 void Shader::use() {
@@ -69,21 +128,64 @@ void Shader::use() {
 }
 
 void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    glUniform4f(locationOf(name), x, y, z, w);
 }
 
 void Shader::setVec2(const std::string& name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(locationOf(name), x, y);
 }
 
 void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(locationOf(name), value);
 }
 
 void Shader::setMat4(const std::string& name, const float* value) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, value);
+    glUniformMatrix4fv(locationOf(name), 1, GL_FALSE, value);
 }
 
 void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(locationOf(name), value);
+}
+
+FrameUniforms::FrameUniforms() : UBO(0) {
+}
+
+FrameUniforms::~FrameUniforms() {
+    release();
+}
+
+void FrameUniforms::release() {
+    if (UBO) {
+        glDeleteBuffers(1, &UBO);
+        UBO = 0;
+    }
+}
+
+// std140 layout of the FrameData block
+static const GLsizeiptr FRAME_PROJECTION_OFFSET = 0;
+static const GLsizeiptr FRAME_TEXT_PROJECTION_OFFSET = 16 * sizeof(float);
+static const GLsizeiptr FRAME_TIME_OFFSET = 32 * sizeof(float);
+static const GLsizeiptr FRAME_DATA_SIZE = 36 * sizeof(float);
+
+bool FrameUniforms::init() {
+    glGenBuffers(1, &UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, FRAME_DATA_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, UBO);
+    return UBO != 0;
+}
+
+void FrameUniforms::update(const float* projection, const float* textProjection, float time) {
+    float data[FRAME_DATA_SIZE / sizeof(float)] = {};
+    for (int i = 0; i < 16; i++) {
+        data[FRAME_PROJECTION_OFFSET / sizeof(float) + i] = projection[i];
+        data[FRAME_TEXT_PROJECTION_OFFSET / sizeof(float) + i] = textProjection[i];
+    }
+    data[FRAME_TIME_OFFSET / sizeof(float)] = time;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, FRAME_DATA_SIZE, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, UBO);
 }
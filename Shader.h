@@ -1,20 +1,98 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <map>
 #include <string>
 #include "dependente/glew/glew.h"
 
+// Uniform block shared by every shader that declares it:
+//
+//   layout(std140) uniform FrameData {
+//       mat4 uProjection;      // World space -> clip space
+//       mat4 uTextProjection;  // Screen pixels -> clip space
+//       float uTime;           // Simulation time in seconds
+//   };
+//
+// Shaders bind it to FRAME_DATA_BINDING at link time; FrameUniforms fills
+// it once per frame.
+static const GLuint FRAME_DATA_BINDING = 0;
+
 class Shader {
 public:
+    // Location of a uniform, resolved once from the reflected uniform table.
+    // The template argument is the GLSL type it was checked against, so a
+    // handle can only be passed to the matching set() overload.
+    template <GLenum Type>
+    struct Uniform {
+        GLint location;
+        Uniform() : location(-1) {}
+        explicit Uniform(GLint loc) : location(loc) {}
+    };
+    typedef Uniform<GL_FLOAT> UniformFloat;
+    typedef Uniform<GL_FLOAT_VEC2> UniformVec2;
+    typedef Uniform<GL_FLOAT_VEC3> UniformVec3;
+    typedef Uniform<GL_FLOAT_VEC4> UniformVec4;
+    typedef Uniform<GL_FLOAT_MAT4> UniformMat4;
+    typedef Uniform<GL_INT> UniformInt;   // Also bools and samplers
+
     GLuint ID;
 
     Shader(const char* vertexPath, const char* fragmentPath);
     void use();
+
+    // Look up a handle; reports a missing or mistyped uniform once, here,
+    // and returns a handle whose set() calls are ignored by GL
+    template <GLenum Type>
+    Uniform<Type> uniform(const char* name) const {
+        return Uniform<Type>(resolve(name, Type));
+    }
+
+    // Handle setters; the shader must be in use
+    void set(UniformFloat u, float value) const { glUniform1f(u.location, value); }
+    void set(UniformVec2 u, float x, float y) const { glUniform2f(u.location, x, y); }
+    void set(UniformVec3 u, float x, float y, float z) const { glUniform3f(u.location, x, y, z); }
+    void set(UniformVec4 u, float x, float y, float z, float w) const { glUniform4f(u.location, x, y, z, w); }
+    void set(UniformMat4 u, const float* value) const { glUniformMatrix4fv(u.location, 1, GL_FALSE, value); }
+    void set(UniformInt u, int value) const { glUniform1i(u.location, value); }
+
+    // Name-based setters for one-off use; served from the reflected table
+    // without asking the driver
     void setVec4(const std::string& name, float x, float y, float z, float w) const;
     void setVec2(const std::string& name, float x, float y) const;
     void setFloat(const std::string& name, float value) const;
     void setMat4(const std::string& name, const float* value) const;
     void setInt(const std::string& name, int value) const;
+
+private:
+    struct UniformInfo {
+        GLint location;
+        GLenum type;
+    };
+
+    // Record every active default-block uniform and bind known uniform blocks
+    void reflect();
+    GLint locationOf(const std::string& name) const;
+    GLint resolve(const char* name, GLenum type) const;
+
+    std::map<std::string, UniformInfo> uniforms;
+};
+
+// The FrameData uniform buffer, updated and bound once per frame.
+class FrameUniforms {
+public:
+    FrameUniforms();
+    ~FrameUniforms();
+
+    bool init();
+
+    // Upload this frame's values and bind the buffer to FRAME_DATA_BINDING
+    void update(const float* projection, const float* textProjection, float time);
+
+    // Free the buffer; call while the context is still current
+    void release();
+
+private:
+    GLuint UBO;
 };
 
 #endif
@@ -0,0 +1,171 @@
+#include "ShapeBatch.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+const size_t ShapeBatch::SHAPE_BYTES = 4 * sizeof(ShapeBatch::Vertex);
+
+ShapeBatch::ShapeBatch()
+    : shader(0), VAO(0), EBO(0), queue(nullptr), arena(nullptr), pixelSize(0.0f),
+      maxShapes(0), frameShapes(0), overflowReported(false),
+      currentLayer(RENDER_ENTITIES) {
+}
+
+ShapeBatch::~ShapeBatch() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+    }
+    if (EBO) {
+        glDeleteBuffers(1, &EBO);
+    }
+}
+
+bool ShapeBatch::init(GLuint shaderProgram, size_t shapeCapacity, RenderQueue* renderQueue, StreamArena* streamArena) {
+    if (!shaderProgram || shapeCapacity == 0 || !renderQueue || !streamArena) {
+        std::cerr << "ShapeBatch needs a shader, a render queue, a stream arena and a non-zero capacity" << std::endl;
+        return false;
+    }
+    shader = shaderProgram;
+    queue = renderQueue;
+    arena = streamArena;
+    maxShapes = shapeCapacity;
+    vertices.reserve(maxShapes * 4);
+
+    // Every shape is two triangles over its four vertices
+    std::vector<GLuint> indices(maxShapes * 6);
+    for (size_t s = 0; s < maxShapes; s++) {
+        GLuint base = static_cast<GLuint>(s * 4);
+        indices[s * 6 + 0] = base + 0;
+        indices[s * 6 + 1] = base + 1;
+        indices[s * 6 + 2] = base + 2;
+        indices[s * 6 + 3] = base + 0;
+        indices[s * 6 + 4] = base + 2;
+        indices[s * 6 + 5] = base + 3;
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+
+    // Vertices live in the arena; each batch picks its base vertex
+    glBindBuffer(GL_ARRAY_BUFFER, arena->buffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    GLsizei stride = sizeof(Vertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, localX));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, halfWidth));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, r));
+    glEnableVertexAttribArray(3);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void ShapeBatch::begin() {
+    vertices.clear();
+    frameShapes = 0;
+}
+
+void ShapeBatch::setLayer(RenderLayer layer) {
+    if (layer != currentLayer) {
+        flush();
+        currentLayer = layer;
+    }
+}
+
+void ShapeBatch::addCircle(float x, float y, float radius, const glm::vec4& color) {
+    push(x, y, 1.0f, 0.0f, radius, radius, radius, 0.0f, color);
+}
+
+void ShapeBatch::addRing(float x, float y, float radius, float thickness, const glm::vec4& color) {
+    push(x, y, 1.0f, 0.0f, radius, radius, radius, thickness, color);
+}
+
+void ShapeBatch::addRoundedBar(float x, float y, float width, float height, float cornerRadius,
+                               const glm::vec4& color) {
+    float halfWidth = width * 0.5f;
+    float halfHeight = height * 0.5f;
+    push(x + halfWidth, y + halfHeight, 1.0f, 0.0f, halfWidth, halfHeight, cornerRadius, 0.0f, color);
+}
+
+void ShapeBatch::addCapsule(float x0, float y0, float x1, float y1, float radius, const glm::vec4& color) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = std::sqrt(dx * dx + dy * dy);
+    float axisX = 1.0f, axisY = 0.0f;
+    if (length > 0.0f) {
+        axisX = dx / length;
+        axisY = dy / length;
+    }
+    push((x0 + x1) * 0.5f, (y0 + y1) * 0.5f, axisX, axisY,
+         length * 0.5f + radius, radius, radius, 0.0f, color);
+}
+
+void ShapeBatch::push(float x, float y, float axisX, float axisY, float halfWidth, float halfHeight,
+                      float radius, float thickness, const glm::vec4& color) {
+    if (!VAO) return;
+
+    // Keep the frame within the space the arena was sized for; drop what
+    // does not fit
+    if (frameShapes + vertices.size() / 4 + 1 > maxShapes) {
+        if (!overflowReported) {
+            std::cerr << "ShapeBatch full (" << maxShapes << " shapes per frame); dropping shapes" << std::endl;
+            overflowReported = true;
+        }
+        return;
+    }
+
+    Vertex corner;
+    corner.halfWidth = halfWidth;
+    corner.halfHeight = halfHeight;
+    corner.radius = radius;
+    corner.thickness = thickness;
+    corner.r = color.r;
+    corner.g = color.g;
+    corner.b = color.b;
+    corner.a = color.a;
+
+    // The quad covers the shape, half a ring band and a pixel for the edge
+    float margin = 0.5f * thickness + pixelSize;
+    float extentX = halfWidth + margin;
+    float extentY = halfHeight + margin;
+    const float signX[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+    const float signY[4] = { -1.0f, -1.0f, 1.0f, 1.0f };
+    for (int i = 0; i < 4; i++) {
+        corner.localX = signX[i] * extentX;
+        corner.localY = signY[i] * extentY;
+        corner.x = x + corner.localX * axisX - corner.localY * axisY;
+        corner.y = y + corner.localX * axisY + corner.localY * axisX;
+        vertices.push_back(corner);
+    }
+}
+
+void ShapeBatch::flush() {
+    if (vertices.empty()) return;
+
+    // Aligned to whole vertices so the offset is a base vertex
+    size_t shapeCount = vertices.size() / 4;
+    StreamAllocation allocation = arena->allocate(vertices.size() * sizeof(Vertex), sizeof(Vertex));
+    if (!allocation.data) {
+        vertices.clear();
+        return;
+    }
+    std::memcpy(allocation.data, vertices.data(), allocation.size);
+    arena->commit(allocation);
+
+    DrawCommand& command = queue->add(currentLayer, shader, VAO, 0);
+    command.blend = true;
+    command.indexed = true;
+    command.count = static_cast<GLsizei>(shapeCount * 6);
+    command.baseVertex = static_cast<GLint>(allocation.offset / sizeof(Vertex));
+
+    frameShapes += shapeCount;
+    vertices.clear();
+}
@@ -0,0 +1,80 @@
+#ifndef SHAPE_BATCH_H
+#define SHAPE_BATCH_H
+
+#include <vector>
+#include "RenderQueue.h"
+#include "StreamArena.h"
+#include "dependente/glew/glew.h"
+#include "dependente/glm/glm.hpp"
+
+// Circles, rings, rounded bars and capsules drawn as one quad each. The
+// fragment shader evaluates the shape's signed distance, so edges are
+// antialiased and smooth at any size, and every shape costs four vertices
+// whether it is the player or a tiny projectile. Shapes are batched like
+// QuadBatch's quads: a batch only ends when the layer changes, or on
+// flush(), and is queued as one indexed draw.
+class ShapeBatch {
+public:
+    ShapeBatch();
+    ~ShapeBatch();
+
+    // Create the buffers; shaderProgram is built from shape_vertex.glsl and
+    // shape_fragment.glsl. shapeCapacity is the most shapes one frame can
+    // hold; the arena needs SHAPE_BYTES for each of them.
+    bool init(GLuint shaderProgram, size_t shapeCapacity, RenderQueue* renderQueue, StreamArena* streamArena);
+
+    // World units per pixel; quads are grown by this much so the
+    // antialiased edge is not clipped
+    void setPixelSize(float size) { pixelSize = size; }
+
+    // Start a new frame (after the arena's beginFrame)
+    void begin();
+
+    // Layer for the shapes added from now on
+    void setLayer(RenderLayer layer);
+
+    void addCircle(float x, float y, float radius, const glm::vec4& color);
+
+    // Circle outline of the given thickness, centered on radius
+    void addRing(float x, float y, float radius, float thickness, const glm::vec4& color);
+
+    // Bar with its bottom-left corner at (x, y) and corners rounded by
+    // cornerRadius (at most half the height)
+    void addRoundedBar(float x, float y, float width, float height, float cornerRadius, const glm::vec4& color);
+
+    // Line from (x0, y0) to (x1, y1) with round caps of the given radius
+    void addCapsule(float x0, float y0, float x1, float y1, float radius, const glm::vec4& color);
+
+    // Upload the pending shapes and queue their draw
+    void flush();
+
+    // Arena bytes one shape needs, not counting alignment
+    static const size_t SHAPE_BYTES;
+
+private:
+    struct Vertex {
+        float x, y;                          // World position
+        float localX, localY;                // Position in the shape's frame
+        float halfWidth, halfHeight;
+        float radius, thickness;             // Corner radius; ring thickness (0 = filled)
+        float r, g, b, a;
+    };
+
+    // Shape centered on (x, y) whose local x axis points along (axisX, axisY)
+    void push(float x, float y, float axisX, float axisY, float halfWidth, float halfHeight,
+              float radius, float thickness, const glm::vec4& color);
+
+    GLuint shader;
+    GLuint VAO, EBO;
+    RenderQueue* queue;
+    StreamArena* arena;
+    float pixelSize;
+    size_t maxShapes;
+    size_t frameShapes;             // Shapes already uploaded this frame
+    bool overflowReported;
+
+    std::vector<Vertex> vertices;   // Pending shapes, four vertices each
+    RenderLayer currentLayer;
+};
+
+#endif
@@ -0,0 +1,500 @@
+#include "Simulation.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+SimulationConfig::SimulationConfig()
+    : arenaHalfWidth(1920.0f / 1080.0f), arenaHalfHeight(1.0f),
+      baseRadius(0.05f), playerSpeed(0.12f), enemySpeed(0.48f), tickRate(60.0f),
+      initialEnemies(2), maxEnemies(4), enemiesToKill(5),
+      enemySpawnInterval(4.0f), gridCellSize(0.2f), maxProjectiles(2048),
+      workerThreads(-1), seed(1), verbose(true) {
+}
+
+Simulation::Simulation(const SimulationConfig& cfg)
+    : player(0.0f, 0.0f, cfg.baseRadius, cfg.playerSpeed),
+      arrowSpeed(1.2f), arrowCooldown(0.25f),
+      tickCount(0), time(0.0), gameWon(false), winTime(0.0),
+      totalEnemiesSpawned(0), totalEnemiesKilled(0), enemiesToKill(cfg.enemiesToKill),
+      config(cfg), tickDuration(1.0f / cfg.tickRate), deltaTime(1.0f / cfg.tickRate),
+      jobs(cfg.workerThreads),
+      mouseWasPressed(false), rightMouseWasPressed(false),
+      arrowCooldownTimer(0.0f), maxEnemyReach(0.0f),
+      enemySpawnTimer(0.0f), damageTimer(0.0f), damageCooldown(3.0f) {
+    // The only projectile allocation; spawning afterwards reuses slots
+    projectiles.init(static_cast<size_t>(cfg.maxProjectiles));
+    reset();
+}
+
+void Simulation::reset() {
+    player = Player(0.0f, 0.0f, config.baseRadius, config.playerSpeed);
+    enemies.clear();
+    projectiles.clear();
+
+    // Initialize sword parameters - simplified
+    sword.offsetX = config.baseRadius * 2.5f;  // Initial position
+    sword.offsetY = 0.0f;
+    sword.prevOffsetX = sword.offsetX;
+    sword.prevOffsetY = sword.offsetY;
+    sword.angle = 0.0f;
+    sword.length = config.baseRadius * 3.5f;
+    sword.width = config.baseRadius * 0.4f;
+    sword.hitboxRadius = config.baseRadius * 1.5f;
+    sword.isSwinging = false;
+    sword.swingSpeed = 3.0f;            // Moderate speed for visibility (1/3 s swing)
+    sword.swingAngle = 3.14159f * 2.0f; // Not used in new system
+    sword.swingProgress = 0.0f;
+    sword.damage = 75;                  // One swing fells a fresh enemy
+    sword.swingId = 0;
+    sword.cooldown = 1.0f;              // 1 second cooldown
+    sword.cooldownTimer = 0.0f;
+
+    tickCount = 0;
+    time = 0.0;
+    gameWon = false;
+    winTime = 0.0;
+    totalEnemiesSpawned = 0;
+    totalEnemiesKilled = 0;
+    enemiesToKill = config.enemiesToKill;
+
+    mouseWasPressed = false;
+    rightMouseWasPressed = false;
+    arrowCooldownTimer = 0.0f;
+    enemySpawnTimer = 0.0f;
+    damageTimer = 0.0f;
+
+    // Restart the spawn stream so a reset replays the same game
+    spawnRng.seed(deriveSeed(config.seed, STREAM_SPAWN));
+
+    grid.configure(-config.arenaHalfWidth, -config.arenaHalfHeight,
+                   config.arenaHalfWidth, config.arenaHalfHeight, config.gridCellSize);
+
+    spawnEnemies(config.initialEnemies);
+}
+
+void Simulation::handleInput(const InputState& input) {
+    // Update player movement
+    player.update(input, deltaTime);
+
+    // Handle arrow firing on left mouse click (debounced, limited by cooldown)
+    if (arrowCooldownTimer > 0.0f) {
+        arrowCooldownTimer -= deltaTime;
+    }
+    if (input.fireArrow) {
+        if (arrowCooldownTimer <= 0.0f && !mouseWasPressed && !player.isDead) {
+            float dirX = input.aimX - player.x;
+            float dirY = input.aimY - player.y;
+            float len = std::sqrt(dirX * dirX + dirY * dirY);
+            if (len != 0) {
+                dirX /= len;
+                dirY /= len;
+            }
+            projectiles.spawn(player.x, player.y, arrowSpeed * dirX, arrowSpeed * dirY,
+                              config.baseRadius * 0.2f, 10, FACTION_PLAYER, ProjectilePool::NO_OWNER);
+            arrowCooldownTimer = arrowCooldown;
+            mouseWasPressed = true;
+        }
+    }
+    else {
+        mouseWasPressed = false;
+    }
+
+    // Handle sword swing on right mouse click - SIMPLIFIED
+    if (input.swingSword) {
+        if (!sword.isSwinging && sword.cooldownTimer <= 0 && !rightMouseWasPressed && !player.isDead) {
+            // Start sword attack - simple and reliable
+            sword.isSwinging = true;
+            sword.swingProgress = 0.0f;
+            sword.swingId++;
+            rightMouseWasPressed = true;
+
+            if (config.verbose) {
+                std::cout << "Starting sword attack!" << std::endl;
+            }
+        }
+    }
+    else {
+        rightMouseWasPressed = false;
+    }
+
+    // For testing purposes, damage player every few seconds (T key)
+    if (input.debugDamage) {
+        damageTimer += deltaTime;
+        if (damageTimer >= damageCooldown) {
+            player.takeDamage(10);
+            damageTimer = 0.0f;
+        }
+    }
+
+    // For testing purposes, heal player (H key)
+    if (input.debugHeal) {
+        player.heal(5);
+    }
+
+    // For testing purposes, kill player instantly (K key)
+    if (input.debugKill && !player.isDead) {
+        player.takeDamage(player.currentHealth);
+    }
+}
+
+void Simulation::spawnEnemies(int count) {
+    float halfWidth = config.arenaHalfWidth;
+    float halfHeight = config.arenaHalfHeight;
+    float baseRadius = config.baseRadius;
+
+    // Only spawn if we have less than the maximum number of enemies AND
+    // haven't spawned the total number needed for the game
+    count = std::min(count, config.maxEnemies - static_cast<int>(enemies.size()));
+    count = std::min(count, enemiesToKill - totalEnemiesSpawned);
+    if (count <= 0) return;
+
+    // Spawn enemies at random positions around the player
+    spawnAngles.resize(count);
+    spawnDistances.resize(count);
+    spawnRng.fill(spawnAngles.data(), count, 0, 2 * 3.14159f);
+    spawnRng.fill(spawnDistances.data(), count, 1.0f, 1.8f);  // Spawn farther away from the player
+
+    for (int i = 0; i < count; i++) {
+        float spawnX = player.x + std::cos(spawnAngles[i]) * spawnDistances[i];
+        float spawnY = player.y + std::sin(spawnAngles[i]) * spawnDistances[i];
+
+        // Clamp to arena boundaries
+        if (spawnX < -halfWidth + baseRadius) spawnX = -halfWidth + baseRadius;
+        if (spawnX > halfWidth - baseRadius) spawnX = halfWidth - baseRadius;
+        if (spawnY < -halfHeight + baseRadius) spawnY = -halfHeight + baseRadius;
+        if (spawnY > halfHeight - baseRadius) spawnY = halfHeight - baseRadius;
+
+        // Add new enemy with its own AI stream, keyed by spawn order
+        uint64_t enemySeed = deriveSeed(config.seed, STREAM_ENEMY_BASE + static_cast<uint64_t>(totalEnemiesSpawned));
+        enemies.add(spawnX, spawnY, baseRadius, config.enemySpeed, enemySeed);
+        totalEnemiesSpawned++;
+        if (config.verbose) {
+            std::cout << "Spawned enemy " << totalEnemiesSpawned << "/" << enemiesToKill << std::endl;
+        }
+    }
+}
+
+void Simulation::savePreviousState() {
+    // Remember where everything was so the renderer can interpolate
+    // between the previous and current tick
+    player.prevX = player.x;
+    player.prevY = player.y;
+    sword.prevOffsetX = sword.offsetX;
+    sword.prevOffsetY = sword.offsetY;
+    enemies.prevX = enemies.x;
+    enemies.prevY = enemies.y;
+
+    // Projectiles record their previous position in ProjectilePool::integrate
+}
+
+void Simulation::step(const InputState& input) {
+    deltaTime = tickDuration;
+
+    // Derived from the tick count so the clock never drifts or stalls,
+    // however long the run
+    tickCount++;
+    time = static_cast<double>(tickCount) / config.tickRate;
+
+    bool wasDead = player.isDead;
+
+    savePreviousState();
+    handleInput(input);
+
+    // Spawn enemies periodically
+    if (static_cast<int>(enemies.size()) < config.maxEnemies && totalEnemiesSpawned < enemiesToKill) {
+        enemySpawnTimer += deltaTime;
+        if (enemySpawnTimer >= config.enemySpawnInterval) {
+            spawnEnemies(1);  // Spawn one enemy at a time
+            enemySpawnTimer = 0.0f;
+        }
+    }
+
+    // Broadphase for the sword and player arrows
+    rebuildGrid(false);
+
+    // Update sword
+    updateSword();
+
+    // Check win condition
+    checkWinCondition();
+
+    updateProjectiles();
+    updateEnemies();
+    removeDeadEnemies();
+    resolveCollisions();
+    clampToArena();
+
+    // Record time of death for the death screen timer
+    if (player.isDead && !wasDead) {
+        player.timeOfDeath = time;
+    }
+}
+
+void Simulation::rebuildGrid(bool includeEnemyProjectiles) {
+    grid.clear();
+    maxEnemyReach = 0.0f;
+
+    for (size_t i = 0; i < enemies.size(); i++) {
+        if (enemies.isDead(i)) continue;
+        grid.insert(static_cast<uint32_t>(i), enemies.x[i], enemies.y[i], enemies.radius[i], LAYER_ENEMY);
+
+        const EnemyTuning& tuning = enemies.tuning[i];
+        maxEnemyReach = std::max(maxEnemyReach, std::max(tuning.collisionRadius, tuning.meleeRange));
+    }
+
+    if (includeEnemyProjectiles) {
+        for (size_t p = 0; p < projectiles.highWater(); p++) {
+            if (!projectiles.active[p] || projectiles.faction[p] != FACTION_ENEMY) continue;
+            grid.insert(static_cast<uint32_t>(p), projectiles.x[p], projectiles.y[p],
+                        projectiles.radius[p], LAYER_ENEMY_PROJECTILE);
+        }
+    }
+
+    grid.build();
+}
+
+void Simulation::updateProjectiles() {
+    // Move every arrow, player and enemy alike
+    projectiles.integrate(deltaTime);
+
+    for (size_t p = 0; p < projectiles.highWater(); p++) {
+        if (!projectiles.active[p] || projectiles.faction[p] != FACTION_PLAYER) continue;
+
+        // Check collision with enemies along the path travelled this tick,
+        // so a fast arrow cannot skip over a target between ticks
+        grid.querySegment(projectiles.prevX[p], projectiles.prevY[p], projectiles.x[p], projectiles.y[p],
+                          projectiles.radius[p], LAYER_ENEMY, nearby);
+
+        // Hit the first enemy along the path
+        size_t target = EnemyPool::npos;
+        float targetDist = 0.0f;
+        for (uint32_t i : nearby) {
+            if (enemies.isDead(i)) continue;
+            float dx = enemies.x[i] - projectiles.prevX[p];
+            float dy = enemies.y[i] - projectiles.prevY[p];
+            float dist = dx * dx + dy * dy;
+            if (target == EnemyPool::npos || dist < targetDist) {
+                target = i;
+                targetDist = dist;
+            }
+        }
+        if (target != EnemyPool::npos) {
+            Enemy::takeDamage(enemies, target, projectiles.damage[p]);
+            projectiles.kill(p);
+        }
+    }
+
+    // Drop arrows that left the arena only now, so one that hit an enemy
+    // near the wall on its way out was still tested along its whole path
+    projectiles.cullOutside(-config.arenaHalfWidth, -config.arenaHalfHeight,
+                            config.arenaHalfWidth, config.arenaHalfHeight);
+}
+
+void Simulation::updateEnemies() {
+    // AI and movement; enemies that shoot add arrows to the projectile pool
+    Enemy::updateAll(enemies, perception, deferred, jobs, player.x, player.y, deltaTime, projectiles);
+
+    if (player.isDead) return;
+
+    // Enemies and their arrows have moved; rebuild the broadphase
+    rebuildGrid(true);
+
+    // Handle collision with player (both directions) and melee attacks
+    float contactReach = maxEnemyReach + std::max(player.radius, player.collisionRadius);
+    grid.queryRadius(player.x, player.y, contactReach, LAYER_ENEMY, nearby);
+    for (uint32_t i : nearby) {
+        if (enemies.isDead(i)) continue;
+
+        Enemy::handleCollision(enemies, i, player.x, player.y, player.radius, deltaTime);
+        player.handleCollision(enemies.x[i], enemies.y[i], enemies.radius[i], deltaTime);
+
+        // Check for melee attacks on player
+        if (!player.isInvulnerable) {
+            int meleeDamage = 0;
+            if (Enemy::checkMeleeHit(enemies, i, player.x, player.y, player.radius, meleeDamage)) {
+                player.takeDamage(meleeDamage);
+            }
+        }
+    }
+
+    // Check if any enemy arrow hits the player
+    if (!player.isDead && !player.isInvulnerable) {
+        grid.queryOverlap(player.x, player.y, player.radius, LAYER_ENEMY_PROJECTILE, nearby);
+        if (!nearby.empty()) {
+            // The hit makes the player invulnerable, so only the first arrow counts
+            size_t p = nearby.front();
+            player.takeDamage(projectiles.damage[p]);
+            projectiles.kill(p);
+        }
+    }
+}
+
+void Simulation::removeDeadEnemies() {
+    // Remove dead enemies and count kills. Removal swaps the last enemy
+    // into slot i, so only advance when the current enemy survives.
+    size_t i = 0;
+    while (i < enemies.size()) {
+        if (enemies.isDead(i)) {
+            totalEnemiesKilled++;
+            if (config.verbose) {
+                std::cout << "Enemy killed! Total kills: " << totalEnemiesKilled << "/" << enemiesToKill << std::endl;
+            }
+            enemies.remove(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void Simulation::resolveCollisions() {
+    // Dead enemies were just removed, so indices changed; rebuild
+    rebuildGrid(false);
+
+    // Handle enemy-to-enemy collisions, each pair once (i < j)
+    for (size_t i = 0; i < enemies.size(); i++) {
+        grid.queryOverlap(enemies.x[i], enemies.y[i], enemies.tuning[i].collisionRadius, LAYER_ENEMY, nearby);
+        for (uint32_t j : nearby) {
+            if (j <= i) continue;
+            Enemy::handleCollision(enemies, i, enemies.x[j], enemies.y[j], enemies.radius[j], deltaTime);
+            Enemy::handleCollision(enemies, j, enemies.x[i], enemies.y[i], enemies.radius[i], deltaTime);
+        }
+    }
+}
+
+void Simulation::clampToArena() {
+    float halfWidth = config.arenaHalfWidth;
+    float halfHeight = config.arenaHalfHeight;
+
+    // Boundary clamping for player
+    if (player.x < -halfWidth + player.radius) player.x = -halfWidth + player.radius;
+    if (player.x > halfWidth - player.radius) player.x = halfWidth - player.radius;
+    if (player.y < -halfHeight + player.radius) player.y = -halfHeight + player.radius;
+    if (player.y > halfHeight - player.radius) player.y = halfHeight - player.radius;
+
+    // Boundary clamping for enemies
+    for (size_t i = 0; i < enemies.size(); i++) {
+        float r = enemies.radius[i];
+        if (enemies.x[i] < -halfWidth + r) enemies.x[i] = -halfWidth + r;
+        if (enemies.x[i] > halfWidth - r) enemies.x[i] = halfWidth - r;
+        if (enemies.y[i] < -halfHeight + r) enemies.y[i] = -halfHeight + r;
+        if (enemies.y[i] > halfHeight - r) enemies.y[i] = halfHeight - r;
+    }
+}
+
+void Simulation::updateSword() {
+    // Update sword cooldown timer
+    if (sword.cooldownTimer > 0) {
+        sword.cooldownTimer -= deltaTime;
+        if (sword.cooldownTimer < 0) {
+            sword.cooldownTimer = 0;
+        }
+    }
+
+    // Simple, reliable sword positioning driven by the simulation clock
+    float currentTime = static_cast<float>(time);
+
+    // If not swinging, sword orbits around player
+    if (!sword.isSwinging) {
+        // Simple orbital motion
+        float orbitAngle = currentTime * 0.5f; // Slow orbit
+        float orbitDistance = player.radius * 2.5f;
+
+        sword.offsetX = cos(orbitAngle) * orbitDistance;
+        sword.offsetY = sin(orbitAngle) * orbitDistance;
+        sword.angle = orbitAngle;
+    }
+    // If swinging, do simple attack animation
+    else {
+        // Simple progress increment
+        sword.swingProgress += sword.swingSpeed * deltaTime;
+
+        // If animation is complete, reset everything
+        if (sword.swingProgress >= 1.0f) {
+            // Reset to normal state
+            sword.isSwinging = false;
+            sword.swingProgress = 0.0f;
+            sword.cooldownTimer = sword.cooldown;
+
+            // Immediately set to current orbital position
+            float orbitAngle = currentTime * 0.5f;
+            float orbitDistance = player.radius * 2.5f;
+            sword.offsetX = cos(orbitAngle) * orbitDistance;
+            sword.offsetY = sin(orbitAngle) * orbitDistance;
+            sword.angle = orbitAngle;
+
+            if (config.verbose) {
+                std::cout << "Sword attack finished, reset to orbit" << std::endl;
+            }
+        }
+        else {
+            // Simple 3-phase attack animation
+            float attackDistance = player.radius * 1.8f; // Closer during attack
+
+            if (sword.swingProgress < 0.33f) {
+                // Phase 1: Move to attack position (33% of animation)
+                float phase1 = sword.swingProgress / 0.33f;
+                float startAngle = sword.angle;
+                float targetAngle = startAngle + (3.14159f / 2.0f); // 90 degrees
+
+                float currentAngle = startAngle + (targetAngle - startAngle) * phase1;
+                sword.offsetX = cos(currentAngle) * attackDistance;
+                sword.offsetY = sin(currentAngle) * attackDistance;
+                sword.angle = currentAngle;
+            }
+            else if (sword.swingProgress < 0.66f) {
+                // Phase 2: Swing around player (33% of animation)
+                float phase2 = (sword.swingProgress - 0.33f) / 0.33f;
+                float swingAngle = sword.angle + (3.14159f * 2.0f * phase2); // Full circle
+
+                sword.offsetX = cos(swingAngle) * attackDistance;
+                sword.offsetY = sin(swingAngle) * attackDistance;
+                sword.angle = swingAngle;
+
+                // Check for enemy hits during this phase: every enemy
+                // overlapping the sword's hitbox takes damage, once per
+                // swing however many ticks the phase lasts
+                grid.queryOverlap(player.x + sword.offsetX, player.y + sword.offsetY,
+                                  sword.hitboxRadius, LAYER_ENEMY, nearby);
+                for (uint32_t i : nearby) {
+                    EnemyBrain& brain = enemies.brain[i];
+                    if (brain.lastSwordSwing == sword.swingId) continue;
+                    brain.lastSwordSwing = sword.swingId;
+                    Enemy::takeDamage(enemies, i, static_cast<int>(sword.damage));
+                }
+            }
+            else {
+                // Phase 3: Return to orbit position (33% of animation)
+                float phase3 = (sword.swingProgress - 0.66f) / 0.34f;
+                float currentAngle = sword.angle;
+                float targetOrbitAngle = currentTime * 0.5f;
+                float targetDistance = player.radius * 2.5f;
+
+                // Interpolate back to orbit
+                float finalAngle = currentAngle + (targetOrbitAngle - currentAngle) * phase3;
+                float finalDistance = attackDistance + (targetDistance - attackDistance) * phase3;
+
+                sword.offsetX = cos(finalAngle) * finalDistance;
+                sword.offsetY = sin(finalAngle) * finalDistance;
+                sword.angle = finalAngle;
+            }
+        }
+    }
+
+    // Debug output
+    if (config.verbose) {
+        std::cout << "Sword state - Swinging: " << sword.isSwinging
+                  << ", Progress: " << sword.swingProgress
+                  << ", Position: (" << sword.offsetX << ", " << sword.offsetY << ")" << std::endl;
+    }
+}
+
+void Simulation::checkWinCondition() {
+    // Check if we've killed enough enemies to win
+    if (!gameWon && totalEnemiesKilled >= enemiesToKill) {
+        gameWon = true;
+        winTime = time;
+        if (config.verbose) {
+            std::cout << "Victory! You killed " << totalEnemiesKilled << " enemies!" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <vector>
+#include "InputState.h"
+#include "Random.h"
+#include "Player.h"
+#include "EnemyPool.h"
+#include "EnemyPerception.h"
+#include "JobSystem.h"
+#include "ProjectilePool.h"
+#include "SpatialGrid.h"
+
+// Tunables for one simulation instance. The defaults reproduce the
+// original game; headless runs override them to stress the systems.
+struct SimulationConfig {
+    float arenaHalfWidth;      // World X spans [-arenaHalfWidth, arenaHalfWidth]
+    float arenaHalfHeight;     // World Y spans [-arenaHalfHeight, arenaHalfHeight]
+    float baseRadius;          // Radius of player and enemy circles
+    float playerSpeed;         // World units per second
+    float enemySpeed;          // World units per second
+    float tickRate;            // Fixed simulation steps per second (e.g. 60 or 120)
+    int initialEnemies;        // Enemies spawned by reset()
+    int maxEnemies;            // Maximum simultaneous enemies
+    int enemiesToKill;         // Kills needed to win (also total enemies spawned)
+    float enemySpawnInterval;  // Seconds between periodic spawns
+    float gridCellSize;        // Broadphase cell size in world units
+    int maxProjectiles;        // Capacity of the shared arrow pool
+    int workerThreads;         // Extra threads for enemy AI (0 = serial, -1 = one per spare core)
+    uint64_t seed;             // Game seed; every random stream is derived from it
+    bool verbose;              // Print gameplay events to stdout
+
+    SimulationConfig();
+};
+
+// Window-free game core: player, enemies, arrows, sword and win/death logic.
+// Knows nothing about GLFW or OpenGL; it is driven purely by InputState and
+// advances in fixed ticks of 1/tickRate seconds, so it can run under the game
+// window or on a headless box and behaves the same at any frame rate.
+class Simulation {
+public:
+    explicit Simulation(const SimulationConfig& config);
+
+    // Restore the initial state (player at origin, initial enemies spawned)
+    void reset();
+
+    // Advance the game by one fixed tick using the given input
+    void step(const InputState& input);
+
+    const SimulationConfig& getConfig() const { return config; }
+    float getTickDuration() const { return tickDuration; }
+    int getThreadCount() const { return jobs.threadCount(); }
+
+    // Sword properties
+    struct Sword {
+        float offsetX, offsetY;    // Offset from player position
+        float prevOffsetX, prevOffsetY; // Offset at the start of the current tick
+        float angle;               // Current angle in radians
+        float length;              // Length of the sword
+        float width;               // Width of the sword blade
+        float hitboxRadius;        // Radius of the sword's hit area
+        bool isSwinging;           // Whether the sword is currently in swing animation
+        float swingSpeed;          // Swing animation progress per second
+        float swingAngle;          // Total angle to swing
+        float swingProgress;       // Current progress of swing (0.0 to 1.0)
+        float damage;              // Damage dealt to each enemy hit, once per swing
+        uint32_t swingId;          // Bumped at the start of every swing
+        float cooldown;            // Cooldown between swings
+        float cooldownTimer;       // Current cooldown timer
+    };
+
+    // Game entities
+    Player player;
+    EnemyPool enemies;
+    ProjectilePool projectiles;  // Player and enemy arrows
+    float arrowSpeed;
+    float arrowCooldown;         // Seconds between player shots
+    Sword sword;
+
+    // Game state
+    uint64_t tickCount;        // Ticks simulated since reset
+    double time;               // Simulation clock in seconds, tickCount / tickRate
+    bool gameWon;
+    double winTime;
+    int totalEnemiesSpawned;   // Track total enemies ever spawned
+    int totalEnemiesKilled;
+    int enemiesToKill;         // Number of enemies needed to win
+
+private:
+    void savePreviousState();
+    void handleInput(const InputState& input);
+    void spawnEnemies(int count);
+    void updateProjectiles();
+    void updateEnemies();
+    void removeDeadEnemies();
+    void resolveCollisions();
+    void clampToArena();
+    void updateSword();
+    void checkWinCondition();
+
+    // Rebuild the broadphase from current positions; enemy ids are dense
+    // pool indices, enemy projectile ids are projectile pool slots
+    void rebuildGrid(bool includeEnemyProjectiles);
+
+    SimulationConfig config;
+    float tickDuration;        // Seconds per tick (1 / tickRate)
+    float deltaTime;           // Step currently being simulated
+    JobSystem jobs;            // Runs enemy AI in parallel batches
+
+    // Input edge detection
+    bool mouseWasPressed;
+    bool rightMouseWasPressed;
+    float arrowCooldownTimer;
+
+    // Enemy AI scratch (distances, next states, state buckets, deferred writes)
+    EnemyPerception perception;
+    EnemyDeferred deferred;
+
+    // Broadphase
+    SpatialGrid grid;
+    std::vector<uint32_t> nearby;   // Reused query results
+    float maxEnemyReach;            // Largest enemy collision/melee range in the grid
+
+    // Spawn positions (STREAM_SPAWN) and reused bulk-fill buffers
+    Rng spawnRng;
+    std::vector<float> spawnAngles;
+    std::vector<float> spawnDistances;
+
+    // Timers
+    float enemySpawnTimer;
+    float damageTimer;
+    float damageCooldown;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid()
+    : originX(0.0f), originY(0.0f), cellSize(1.0f), inverseCellSize(1.0f),
+      columns(1), rows(1), maxRadius(0.0f) {
+    cellStart.assign(2, 0);
+}
+
+void SpatialGrid::configure(float minX, float minY, float maxX, float maxY, float size) {
+    originX = minX;
+    originY = minY;
+    cellSize = size;
+    inverseCellSize = 1.0f / size;
+    columns = std::max(1, static_cast<int>(std::ceil((maxX - minX) * inverseCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil((maxY - minY) * inverseCellSize)));
+    clear();
+}
+
+void SpatialGrid::clear() {
+    itemId.clear();
+    itemX.clear();
+    itemY.clear();
+    itemRadius.clear();
+    itemLayer.clear();
+    itemCell.clear();
+    sortedItems.clear();
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    maxRadius = 0.0f;
+}
+
+int SpatialGrid::cellCoordX(float x) const {
+    int cx = static_cast<int>(std::floor((x - originX) * inverseCellSize));
+    return std::min(std::max(cx, 0), columns - 1);
+}
+
+int SpatialGrid::cellCoordY(float y) const {
+    int cy = static_cast<int>(std::floor((y - originY) * inverseCellSize));
+    return std::min(std::max(cy, 0), rows - 1);
+}
+
+void SpatialGrid::insert(uint32_t id, float x, float y, float radius, uint32_t layer) {
+    itemId.push_back(id);
+    itemX.push_back(x);
+    itemY.push_back(y);
+    itemRadius.push_back(radius);
+    itemLayer.push_back(layer);
+    itemCell.push_back(static_cast<uint32_t>(cellCoordY(y) * columns + cellCoordX(x)));
+    maxRadius = std::max(maxRadius, radius);
+}
+
+void SpatialGrid::build() {
+    // Counting sort of items by cell
+    size_t cellCount = static_cast<size_t>(columns) * rows;
+    cellStart.assign(cellCount + 1, 0);
+    for (uint32_t cell : itemCell) {
+        cellStart[cell + 1]++;
+    }
+    for (size_t c = 0; c < cellCount; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    // Scatter items into their cells
+    sortedItems.resize(itemCell.size());
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < itemCell.size(); i++) {
+        sortedItems[cellCursor[itemCell[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+template <typename Visitor>
+void SpatialGrid::visitBox(float minX, float minY, float maxX, float maxY, uint32_t layerMask, Visitor visit) const {
+    if (sortedItems.empty()) return;
+
+    // Items are binned by center, so widen the box by the largest radius
+    int x0 = cellCoordX(minX - maxRadius);
+    int y0 = cellCoordY(minY - maxRadius);
+    int x1 = cellCoordX(maxX + maxRadius);
+    int y1 = cellCoordY(maxY + maxRadius);
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            size_t cell = static_cast<size_t>(cy) * columns + cx;
+            for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                uint32_t item = sortedItems[k];
+                if (itemLayer[item] & layerMask) {
+                    visit(item);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryOverlap(float x, float y, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const {
+    results.clear();
+    visitBox(x - radius, y - radius, x + radius, y + radius, layerMask, [&](uint32_t item) {
+        float dx = itemX[item] - x;
+        float dy = itemY[item] - y;
+        float reach = itemRadius[item] + radius;
+        if (dx * dx + dy * dy < reach * reach) {
+            results.push_back(itemId[item]);
+        }
+    });
+}
+
+void SpatialGrid::queryRadius(float x, float y, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const {
+    results.clear();
+    visitBox(x - radius, y - radius, x + radius, y + radius, layerMask, [&](uint32_t item) {
+        float dx = itemX[item] - x;
+        float dy = itemY[item] - y;
+        if (dx * dx + dy * dy <= radius * radius) {
+            results.push_back(itemId[item]);
+        }
+    });
+}
+
+void SpatialGrid::querySegment(float x0, float y0, float x1, float y1, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const {
+    results.clear();
+
+    float segX = x1 - x0;
+    float segY = y1 - y0;
+    float segLengthSq = segX * segX + segY * segY;
+
+    visitBox(std::min(x0, x1) - radius, std::min(y0, y1) - radius,
+             std::max(x0, x1) + radius, std::max(y0, y1) + radius, layerMask, [&](uint32_t item) {
+        // Closest point on the segment to the circle center
+        float t = 0.0f;
+        if (segLengthSq > 0.0f) {
+            t = ((itemX[item] - x0) * segX + (itemY[item] - y0) * segY) / segLengthSq;
+            t = std::min(std::max(t, 0.0f), 1.0f);
+        }
+        float dx = itemX[item] - (x0 + segX * t);
+        float dy = itemY[item] - (y0 + segY * t);
+        float reach = itemRadius[item] + radius;
+        if (dx * dx + dy * dy < reach * reach) {
+            results.push_back(itemId[item]);
+        }
+    });
+}
@@ -0,0 +1,74 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Collision layers. Every item in the grid belongs to one layer; queries
+// take a mask of the layers they are interested in. The player and player
+// arrows are not in the grid: they are the ones doing the querying.
+enum CollisionLayer : uint32_t {
+    LAYER_ENEMY             = 1u << 0,
+    LAYER_ENEMY_PROJECTILE  = 1u << 1,
+    LAYER_ALL               = 0xFFFFFFFFu
+};
+
+// Uniform-grid broadphase for circles.
+//
+// Usage per tick: clear(), insert() every circle, build(), then query.
+// Each circle is binned by its center; queries widen their search by the
+// largest inserted radius, so circles bigger than a cell are still found.
+// All tests compare squared distances. Queries clear the result vector and
+// fill it with the ids passed to insert(), in grid order.
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    // Set the covered area and cell size. Circles outside the area are
+    // clamped into the border cells, so they are still found.
+    void configure(float minX, float minY, float maxX, float maxY, float cellSize);
+
+    void clear();
+    void insert(uint32_t id, float x, float y, float radius, uint32_t layer);
+    void build();
+
+    // Circles overlapping the circle (x, y, radius)
+    void queryOverlap(float x, float y, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const;
+
+    // Circles whose centers lie within radius of (x, y)
+    void queryRadius(float x, float y, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const;
+
+    // Circles touched by a circle of the given radius swept from (x0, y0) to (x1, y1)
+    void querySegment(float x0, float y0, float x1, float y1, float radius, uint32_t layerMask, std::vector<uint32_t>& results) const;
+
+    size_t size() const { return itemId.size(); }
+
+private:
+    int cellCoordX(float x) const;
+    int cellCoordY(float y) const;
+
+    // Visit every item on the given layers whose cell may overlap the box;
+    // the visitor does the exact test
+    template <typename Visitor>
+    void visitBox(float minX, float minY, float maxX, float maxY, uint32_t layerMask, Visitor visit) const;
+
+    float originX, originY;
+    float cellSize;
+    float inverseCellSize;
+    int columns, rows;
+
+    // Inserted items (structure of arrays)
+    std::vector<uint32_t> itemId;
+    std::vector<float> itemX, itemY, itemRadius;
+    std::vector<uint32_t> itemLayer;
+    std::vector<uint32_t> itemCell;
+    float maxRadius;
+
+    // Built cell table: items of cell c are sortedItems[cellStart[c] .. cellStart[c + 1])
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> sortedItems;
+    std::vector<uint32_t> cellCursor;  // Scratch for build()
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "StreamArena.h"
+#include "dependente/glfw/glfw3.h"
+#include <cstring>
+#include <iostream>
+
+// GL_ARB_buffer_storage (core in 4.4) is newer than the bundled GLEW
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (APIENTRY *BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+StreamArena::StreamArena()
+    : VBO(0), frameSize(0), region(0), cursor(0), mapped(nullptr), staging(nullptr), overflowReported(false) {
+    for (int i = 0; i < FRAMES; i++) {
+        fences[i] = 0;
+    }
+}
+
+StreamArena::~StreamArena() {
+    for (int i = 0; i < FRAMES; i++) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+        }
+    }
+    if (mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if (VBO) {
+        glDeleteBuffers(1, &VBO);
+    }
+    delete[] staging;
+}
+
+bool StreamArena::init(size_t bytesPerFrame) {
+    if (bytesPerFrame == 0) {
+        std::cerr << "StreamArena needs a non-zero frame size" << std::endl;
+        return false;
+    }
+    frameSize = bytesPerFrame;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // Persistent mapping when the driver has immutable buffer storage
+    BufferStorageProc bufferStorage = nullptr;
+    if (glfwExtensionSupported("GL_ARB_buffer_storage")) {
+        bufferStorage = reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage"));
+    }
+    if (bufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_ARRAY_BUFFER, frameSize * FRAMES, nullptr, flags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, frameSize * FRAMES, flags));
+        if (!mapped) {
+            // Immutable storage cannot be resized, so start over with a new buffer
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &VBO);
+            glGenBuffers(1, &VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        }
+    }
+
+    // Orphaning fallback: one frame of storage, replaced every frame
+    if (!mapped) {
+        glBufferData(GL_ARRAY_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+        staging = new unsigned char[frameSize];
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    std::cout << "Stream arena: " << frameSize / 1024 << " KB per frame, "
+              << (mapped ? "persistent mapping" : "orphaning") << std::endl;
+    return true;
+}
+
+void StreamArena::beginFrame() {
+    cursor = 0;
+    if (mapped) {
+        // Reuse the region written FRAMES frames ago once the GPU has read it
+        region = (region + 1) % FRAMES;
+        if (fences[region]) {
+            GLenum result = glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+            }
+            glDeleteSync(fences[region]);
+            fences[region] = 0;
+        }
+    } else if (VBO) {
+        // Last frame's draws keep the old storage
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void StreamArena::endFrame() {
+    if (mapped) {
+        if (fences[region]) {
+            glDeleteSync(fences[region]);
+        }
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+StreamAllocation StreamArena::allocate(size_t bytes, size_t alignment) {
+    StreamAllocation allocation;
+    allocation.data = nullptr;
+    allocation.offset = 0;
+    allocation.size = 0;
+
+    // Offsets are aligned in the whole buffer, not just in the region
+    size_t base = mapped ? region * frameSize : 0;
+    size_t start = base + cursor;
+    if (alignment > 1) {
+        start = (start + alignment - 1) / alignment * alignment;
+    }
+    if (VBO == 0 || start + bytes > base + frameSize) {
+        if (!overflowReported) {
+            std::cerr << "Stream arena full (" << frameSize << " bytes per frame)" << std::endl;
+            overflowReported = true;
+        }
+        return allocation;
+    }
+
+    cursor = start + bytes - base;
+    allocation.data = mapped ? mapped + start : staging + start;
+    allocation.offset = static_cast<GLintptr>(start);
+    allocation.size = bytes;
+    return allocation;
+}
+
+void StreamArena::commit(const StreamAllocation& allocation) {
+    // Coherent persistent writes are already visible
+    if (mapped || !allocation.data || allocation.size == 0) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, allocation.size, allocation.data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
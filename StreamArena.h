@@ -0,0 +1,64 @@
+#ifndef STREAM_ARENA_H
+#define STREAM_ARENA_H
+
+#include <cstddef>
+#include "dependente/glew/glew.h"
+
+// Bytes handed out by StreamArena::allocate. data is where the caller
+// writes, offset is the position of those bytes in StreamArena::buffer().
+// data is null when the frame's space has run out.
+struct StreamAllocation {
+    void* data;
+    GLintptr offset;
+    size_t size;
+};
+
+// One vertex buffer for everything that is rebuilt every frame. Callers
+// bump-allocate space, write their vertices and commit them; nothing is
+// freed, the whole frame's space is reused FRAMES frames later.
+//
+// With GL_ARB_buffer_storage the buffer is mapped once, persistently and
+// coherently, and split into FRAMES regions guarded by fences, so writing
+// is a plain memcpy and never waits on a draw that is still queued. On
+// plain GL 3.3 the allocations are staged in memory and the buffer is
+// orphaned at the start of each frame, so uploads never stall either.
+class StreamArena {
+public:
+    static const int FRAMES = 3;
+
+    StreamArena();
+    ~StreamArena();
+
+    // bytesPerFrame is the most one frame can allocate
+    bool init(size_t bytesPerFrame);
+
+    // Start a frame: wait until the GPU is done with the region written
+    // FRAMES frames ago (or orphan the buffer) and reset the bump pointer
+    void beginFrame();
+
+    // Fence everything drawn from this frame's region
+    void endFrame();
+
+    // Reserve bytes at an offset that is a multiple of alignment, which
+    // may be a vertex size rather than a power of two (so offset /
+    // alignment can be used as a base vertex)
+    StreamAllocation allocate(size_t bytes, size_t alignment = 16);
+
+    // Make the written bytes visible to GL before they are drawn
+    void commit(const StreamAllocation& allocation);
+
+    GLuint buffer() const { return VBO; }
+    bool isPersistent() const { return mapped != nullptr; }
+
+private:
+    GLuint VBO;
+    size_t frameSize;
+    int region;                  // Region of the current frame (persistent mode)
+    size_t cursor;               // Bytes used in the current frame
+    unsigned char* mapped;       // Persistent mapping of all regions, or null
+    unsigned char* staging;      // Fallback: this frame's bytes before upload
+    GLsync fences[FRAMES];
+    bool overflowReported;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "Terrain.h"
+#include "Random.h"
+#include <cmath>
+
+TerrainSettings::TerrainSettings()
+    : halfWidth(1920.0f / 1080.0f), halfHeight(1.0f),
+      elementCount(150), minDistance(0.15f), maxAttempts(100000) {
+}
+
+void generateTerrain(const TerrainSettings& settings, uint64_t seed, std::vector<TerrainElement>& out) {
+    // Clear any existing terrain elements
+    out.clear();
+
+    // Terrain has its own random stream derived from the game seed
+    Rng rng(deriveSeed(seed, STREAM_TERRAIN));
+
+    // Candidate positions are drawn in blocks with the bulk generator
+    const size_t candidateBlock = 64;
+    float candidateX[candidateBlock];
+    float candidateY[candidateBlock];
+    size_t nextCandidate = candidateBlock;
+
+    // Generate scattered terrain elements
+    int attempts = 0;
+    for (int i = 0; i < settings.elementCount && attempts < settings.maxAttempts; i++) {
+        TerrainElement element;
+        attempts++;
+
+        // Random position across the world
+        if (nextCandidate == candidateBlock) {
+            rng.fill(candidateX, candidateBlock, -settings.halfWidth + 0.1f, settings.halfWidth - 0.1f);
+            rng.fill(candidateY, candidateBlock, -settings.halfHeight + 0.1f, settings.halfHeight - 0.1f);
+            nextCandidate = 0;
+        }
+        element.x = candidateX[nextCandidate];
+        element.y = candidateY[nextCandidate];
+        nextCandidate++;
+
+        // Check for overlap with existing elements (minimum distance)
+        bool tooClose = false;
+        float minDistanceSq = settings.minDistance * settings.minDistance;
+
+        for (const auto& existing : out) {
+            float dx = element.x - existing.x;
+            float dy = element.y - existing.y;
+
+            if (dx * dx + dy * dy < minDistanceSq) {
+                tooClose = true;
+                break;
+            }
+        }
+
+        // Skip this element if it's too close to another
+        if (tooClose) {
+            i--; // Try again
+            continue;
+        }
+
+        // Random element type
+        int typeRand = static_cast<int>(rng.below(100));
+        if (typeRand < 35) {
+            element.type = GRASS_BLADE;
+            element.size = rng.range(0.02f, 0.04f);
+        } else if (typeRand < 55) {
+            element.type = STONE_ROCK;
+            element.size = rng.range(0.03f, 0.06f);
+        } else if (typeRand < 75) {
+            element.type = DIRT_PATCH;
+            element.size = rng.range(0.025f, 0.045f);
+        } else if (typeRand < 90) {
+            element.type = COBBLE_STONE;
+            element.size = rng.range(0.04f, 0.07f);
+        } else {
+            element.type = SAND_GRAIN;
+            element.size = rng.range(0.015f, 0.025f);
+        }
+
+        // Random rotation for variety
+        element.rotation = rng.range(0.0f, 6.28318f); // 0 to 2π
+
+        // Grayscale colors with variation
+        float baseGray = 0.0f;
+        float variation = rng.range(0.7f, 1.0f);
+
+        switch (element.type) {
+            case GRASS_BLADE:
+                baseGray = 0.4f * variation; // Medium gray
+                break;
+            case STONE_ROCK:
+                baseGray = 0.6f * variation; // Light gray
+                break;
+            case DIRT_PATCH:
+                baseGray = 0.3f * variation; // Dark gray
+                break;
+            case COBBLE_STONE:
+                baseGray = 0.5f * variation; // Medium-light gray
+                break;
+            case SAND_GRAIN:
+                baseGray = 0.7f * variation; // Lightest gray
+                break;
+        }
+
+        element.gray = baseGray;
+
+        out.push_back(element);
+    }
+}
+
+// Append the unit square [0,1]^2 scaled by (width, height), rotated by
+// angle about its corner and moved to (x, y), as two triangles
+static void addRect(std::vector<TerrainVertex>& out, float x, float y, float angle,
+                    float width, float height, float gray) {
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+
+    // Bottom left, bottom right, top right, bottom left, top right, top left
+    static const float corners[6][2] = {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f },
+        { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+    };
+    for (int i = 0; i < 6; i++) {
+        float px = corners[i][0] * width;
+        float py = corners[i][1] * height;
+        TerrainVertex vertex;
+        vertex.x = x + px * c - py * s;
+        vertex.y = y + px * s + py * c;
+        vertex.r = gray;
+        vertex.g = gray;
+        vertex.b = gray;
+        out.push_back(vertex);
+    }
+}
+
+void buildTerrainMesh(const std::vector<TerrainElement>& elements, std::vector<TerrainVertex>& out) {
+    out.clear();
+    out.reserve(elements.size() * 3 * 6);
+
+    for (const auto& element : elements) {
+        float size = element.size;
+        switch (element.type) {
+            case GRASS_BLADE:
+                // Thin vertical rectangle
+                addRect(out, element.x, element.y, element.rotation, size * 0.3f, size * 2.0f, element.gray);
+                break;
+
+            case STONE_ROCK:
+                // Irregular stone: a rectangle plus a smaller, offset one
+                addRect(out, element.x, element.y, element.rotation, size, size * 0.8f, element.gray);
+                addRect(out, element.x + size * 0.3f, element.y + size * 0.2f, element.rotation + 0.5f,
+                        size * 0.6f, size * 0.5f, element.gray);
+                break;
+
+            case DIRT_PATCH:
+            case SAND_GRAIN:
+                // Small square
+                addRect(out, element.x, element.y, element.rotation, size, size, element.gray);
+                break;
+
+            case COBBLE_STONE:
+            {
+                // Rectangular cobblestone with darker top and side borders
+                float darkGray = element.gray * 0.5f;
+                addRect(out, element.x, element.y, element.rotation, size * 1.2f, size * 0.8f, element.gray);
+                addRect(out, element.x, element.y + size * 0.4f, element.rotation, size * 1.2f, size * 0.05f, darkGray);
+                addRect(out, element.x + size * 0.6f, element.y, element.rotation, size * 0.05f, size * 0.8f, darkGray);
+                break;
+            }
+        }
+    }
+}
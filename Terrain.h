@@ -0,0 +1,51 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <vector>
+#include <cstdint>
+
+// Background terrain layout. Purely decorative: the simulation never reads
+// it, but generation is kept free of OpenGL so it can be benchmarked and
+// tested headless.
+
+enum TileType {
+    GRASS_BLADE = 0,
+    STONE_ROCK = 1,
+    DIRT_PATCH = 2,
+    COBBLE_STONE = 3,
+    SAND_GRAIN = 4
+};
+
+struct TerrainElement {
+    TileType type;
+    float x, y;
+    float size;
+    float rotation; // For variety
+    float gray;     // Grayscale brightness (r = g = b)
+};
+
+// One vertex of the baked terrain mesh, already in world space
+struct TerrainVertex {
+    float x, y;
+    float r, g, b;
+};
+
+struct TerrainSettings {
+    float halfWidth, halfHeight;  // Area to scatter over (minus a 0.1 margin)
+    int elementCount;             // Elements to place
+    float minDistance;            // Minimum distance between element centers
+    int maxAttempts;              // Candidate positions tried before giving up
+
+    TerrainSettings();
+};
+
+// Scatter non-overlapping terrain elements using the STREAM_TERRAIN stream
+// of the given game seed. Stops early if maxAttempts candidates have been
+// tried, so an impossible density cannot hang.
+void generateTerrain(const TerrainSettings& settings, uint64_t seed, std::vector<TerrainElement>& out);
+
+// Bake the elements into one triangle list (six vertices per rectangle,
+// one to three rectangles per element) so static terrain is a single draw.
+void buildTerrainMesh(const std::vector<TerrainElement>& elements, std::vector<TerrainVertex>& out);
+
+#endif
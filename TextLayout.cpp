@@ -0,0 +1,67 @@
+#include "TextLayout.h"
+
+TextLayout::TextLayout()
+    : font(nullptr), scale(0.0f), textWidth(0.0f), builtGeneration(0), VAO(0), VBO(0), vertexCount(0) {
+}
+
+TextLayout::~TextLayout() {
+    release();
+}
+
+void TextLayout::release() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        VAO = 0;
+    }
+    if (VBO) {
+        glDeleteBuffers(1, &VBO);
+        VBO = 0;
+    }
+    font = nullptr;
+    text.clear();
+    vertexCount = 0;
+    textWidth = 0.0f;
+}
+
+void TextLayout::set(Font* newFont, const char* newText, float newScale) {
+    if (newFont == font && newScale == scale && text == newText && VAO) {
+        return;
+    }
+    font = newFont;
+    text = newText;
+    scale = newScale;
+    rebuild();
+}
+
+void TextLayout::rebuild() {
+    textWidth = 0.0f;
+    vertexCount = 0;
+    if (!font || !font->isLoaded()) {
+        return;
+    }
+
+    // Lay out from the origin; draw() moves the whole string
+    vertices.clear();
+    textWidth = font->buildQuads(text, 0.0f, 0.0f, scale, vertices);
+    vertexCount = static_cast<GLsizei>(vertices.size() / Font::VERTEX_FLOATS);
+    builtGeneration = font->generation();
+
+    if (VAO == 0) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        Font::setupVertexArray(VAO, VBO);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TextLayout::draw(float x, float y, glm::vec3 color, const TextEffects& effects) {
+    if (font) {
+        // A cell this layout uses may have been given to another glyph
+        if (font->generation() != builtGeneration) {
+            rebuild();
+        }
+        font->drawQuads(VAO, vertexCount, x, y, color, effects);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <string>
+#include <vector>
+#include "Font.h"
+#include "dependente/glew/glew.h"
+#include "dependente/glm/glm.hpp"
+
+// A string laid out once and kept on the GPU. set() only rebuilds the
+// glyph quads when the text, scale or font changes (or the font's glyph
+// cache evicted something), so drawing an unchanged layout costs no
+// layout work and no allocations; the position is applied at draw time.
+class TextLayout {
+public:
+    TextLayout();
+    ~TextLayout();
+
+    // Lay out text with font at scale; a no-op when nothing changed
+    void set(Font* font, const char* text, float scale);
+
+    // Width in pixels, measured from the glyph advances
+    float width() const { return textWidth; }
+
+    // Draw with the start of the baseline at (x, y) in screen pixels
+    void draw(float x, float y, glm::vec3 color, const TextEffects& effects = TextEffects());
+
+    // Free the GL buffers; call while the context is still current
+    void release();
+
+private:
+    void rebuild();
+
+    Font* font;
+    std::string text;
+    float scale;
+    float textWidth;
+    unsigned int builtGeneration;  // Font glyph cache generation of the quads
+
+    GLuint VAO, VBO;
+    GLsizei vertexCount;
+    std::vector<float> vertices;   // Scratch space for rebuilding
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "WeaponMesh.h"
+#include <cmath>
+
+void ColoredMesh::clear() {
+    vertices.clear();
+    indices.clear();
+}
+
+uint32_t ColoredMesh::addVertex(float x, float y, float r, float g, float b) {
+    MeshVertex vertex;
+    vertex.x = x;
+    vertex.y = y;
+    vertex.r = r;
+    vertex.g = g;
+    vertex.b = b;
+    vertices.push_back(vertex);
+    return static_cast<uint32_t>(vertices.size() - 1);
+}
+
+void ColoredMesh::addTriangle(float x0, float y0, float x1, float y1, float x2, float y2,
+                              float r, float g, float b) {
+    indices.push_back(addVertex(x0, y0, r, g, b));
+    indices.push_back(addVertex(x1, y1, r, g, b));
+    indices.push_back(addVertex(x2, y2, r, g, b));
+}
+
+void ColoredMesh::addQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+                          float r, float g, float b) {
+    uint32_t base = addVertex(x0, y0, r, g, b);
+    addVertex(x1, y1, r, g, b);
+    addVertex(x2, y2, r, g, b);
+    addVertex(x3, y3, r, g, b);
+
+    // Corners in order around the quad
+    const uint32_t order[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int i = 0; i < 6; i++) {
+        indices.push_back(base + order[i]);
+    }
+}
+
+void ColoredMesh::addEllipse(float cx, float cy, float radiusX, float radiusY, int segments,
+                             float r, float g, float b) {
+    uint32_t center = addVertex(cx, cy, r, g, b);
+    for (int i = 0; i < segments; i++) {
+        float angle = 2.0f * 3.14159265358979323846f * i / segments;
+        addVertex(cx + radiusX * std::cos(angle), cy + radiusY * std::sin(angle), r, g, b);
+    }
+
+    // A fan around the center, closing back on the first rim vertex
+    for (int i = 0; i < segments; i++) {
+        indices.push_back(center);
+        indices.push_back(center + 1 + i);
+        indices.push_back(center + 1 + (i + 1) % segments);
+    }
+}
+
+void buildSwordMesh(float length, float width, ColoredMesh& out) {
+    out.clear();
+
+    float bladeLength = length * 0.75f;  // 75% of total length is the blade
+    float handleLength = length * 0.25f; // 25% of total length is the handle
+    float bladeWidth = width;
+    float handleWidth = width * 0.5f;
+    float guardWidth = width * 3.0f;     // Wide crossguard for a medieval look
+    float guardHeight = width * 0.6f;
+
+    // Tapered blade (steel)
+    out.addTriangle(0.0f, bladeLength,
+                    -bladeWidth / 2.0f, guardHeight / 2.0f,
+                    bladeWidth / 2.0f, guardHeight / 2.0f,
+                    0.7f, 0.8f, 0.95f);
+
+    // Fuller (blood groove), from 20% to 85% up the blade
+    float fullerBase = guardHeight / 2.0f + bladeLength * 0.2f;
+    out.addTriangle(0.0f, bladeLength * 0.85f,
+                    -bladeWidth * 0.3f, fullerBase,
+                    bladeWidth * 0.3f, fullerBase,
+                    0.5f, 0.6f, 0.8f);
+
+    // Guard (gold)
+    out.addQuad(-guardWidth / 2.0f, guardHeight / 2.0f,
+                guardWidth / 2.0f, guardHeight / 2.0f,
+                guardWidth / 2.0f, -guardHeight / 2.0f,
+                -guardWidth / 2.0f, -guardHeight / 2.0f,
+                0.9f, 0.7f, 0.2f);
+
+    // Handle (brown)
+    float handleBottom = -guardHeight / 2.0f - handleLength;
+    out.addQuad(-handleWidth / 2.0f, -guardHeight / 2.0f,
+                handleWidth / 2.0f, -guardHeight / 2.0f,
+                handleWidth / 2.0f, handleBottom,
+                -handleWidth / 2.0f, handleBottom,
+                0.6f, 0.3f, 0.1f);
+
+    // Slightly oval pommel (gold, to match the guard)
+    float pommelRadius = handleWidth * 0.8f;
+    out.addEllipse(0.0f, handleBottom - pommelRadius * 0.5f, pommelRadius * 0.6f, pommelRadius, 8,
+                   0.9f, 0.7f, 0.2f);
+}
+
+void buildArrowMesh(float baseRadius, ColoredMesh& out) {
+    out.clear();
+
+    float arrowLength = baseRadius * 1.5f;
+    float headLength = arrowLength * 0.4f;       // 40% of length is the arrowhead
+    float headWidth = baseRadius * 0.6f;
+    float shaftWidth = baseRadius * 0.15f;
+    float fletchingLength = arrowLength * 0.25f;
+    float fletchingWidth = baseRadius * 0.4f;
+    float headBase = arrowLength - headLength;
+
+    // Arrowhead (metallic silver)
+    out.addTriangle(0.0f, arrowLength,
+                    -headWidth / 2.0f, headBase,
+                    headWidth / 2.0f, headBase,
+                    0.8f, 0.8f, 0.9f);
+
+    // Shaft (wood)
+    out.addQuad(-shaftWidth / 2.0f, headBase,
+                shaftWidth / 2.0f, headBase,
+                shaftWidth / 2.0f, fletchingLength,
+                -shaftWidth / 2.0f, fletchingLength,
+                0.6f, 0.4f, 0.2f);
+
+    // Fletching on both sides (reddish brown feathers)
+    out.addTriangle(-shaftWidth / 2.0f, fletchingLength,
+                    -fletchingWidth / 2.0f, 0.0f,
+                    -shaftWidth / 4.0f, fletchingLength * 0.5f,
+                    0.7f, 0.3f, 0.2f);
+    out.addTriangle(shaftWidth / 2.0f, fletchingLength,
+                    fletchingWidth / 2.0f, 0.0f,
+                    shaftWidth / 4.0f, fletchingLength * 0.5f,
+                    0.7f, 0.3f, 0.2f);
+}
@@ -0,0 +1,46 @@
+#ifndef WEAPON_MESH_H
+#define WEAPON_MESH_H
+
+#include <vector>
+#include <cstdint>
+
+// Weapon shapes as indexed, vertex-colored triangle meshes, so a weapon
+// with several differently colored parts is still one draw. Built without
+// OpenGL; the game uploads them and draws them with mesh_vertex.glsl.
+
+// Same layout as TerrainVertex: position in the weapon's own frame, color
+struct MeshVertex {
+    float x, y;
+    float r, g, b;
+};
+
+// Triangles in draw order; later parts cover earlier ones
+struct ColoredMesh {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    void clear();
+
+    // Each part gets its own vertices, so colors stay flat per part
+    void addTriangle(float x0, float y0, float x1, float y1, float x2, float y2,
+                     float r, float g, float b);
+    void addQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+                 float r, float g, float b);
+
+    // Filled ellipse around (cx, cy) with the given radii
+    void addEllipse(float cx, float cy, float radiusX, float radiusY, int segments,
+                    float r, float g, float b);
+
+private:
+    uint32_t addVertex(float x, float y, float r, float g, float b);
+};
+
+// Sword pointing up the y axis with the guard at the origin: blade, fuller,
+// guard, handle and pommel
+void buildSwordMesh(float length, float width, ColoredMesh& out);
+
+// Arrow pointing up the y axis with its tail at the origin: head, shaft
+// and two fletchings, sized from the base entity radius
+void buildArrowMesh(float baseRadius, ColoredMesh& out);
+
+#endif
@@ -0,0 +1,369 @@
+// Benchmark driver: runs scripted scenarios against the simulation core and
+// prints per-tick timings and heap traffic as JSON, so engine changes can be
+// compared with numbers instead of by feel.
+//
+// Usage: knighted_bench [--scenario NAME] [--ticks-scale X] [--threads N]
+//                       [--out FILE] [--list]
+//
+// --scenario runs only the scenarios whose name contains NAME,
+// --ticks-scale multiplies every scenario's tick count (e.g. 0.1 for a
+// smoke run) and --threads sets the total thread count like the headless
+// runner. Results go to stdout unless --out is given.
+#include "Simulation.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Heap traffic counters, fed by the global operator new below. Every
+// allocation in the process goes through them, including the job threads.
+static std::atomic<unsigned long long> allocationCount(0);
+static std::atomic<unsigned long long> allocationBytes(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+enum ScenarioKind {
+    SCENARIO_SWARM,       // Enemies scattered over an arena sized to the crowd
+    SCENARIO_ARROW_STORM, // Ring of archers around a player who keeps firing
+    SCENARIO_MELEE_CLUMP, // Enemies piled on top of the player
+    SCENARIO_TERRAIN      // Terrain generation at a given element count
+};
+
+struct Scenario {
+    const char* name;
+    ScenarioKind kind;
+    int count;      // Enemies, or terrain elements for SCENARIO_TERRAIN
+    long ticks;     // Measured ticks (terrain: generations)
+    long warmup;    // Ticks run before measuring
+};
+
+static const Scenario SCENARIOS[] = {
+    { "enemies_10",      SCENARIO_SWARM,       10,     5000, 200 },
+    { "enemies_1k",      SCENARIO_SWARM,       1000,   2000, 100 },
+    { "enemies_10k",     SCENARIO_SWARM,       10000,  500,  20 },
+    { "enemies_100k",    SCENARIO_SWARM,       100000, 60,   5 },
+    { "arrow_storm",     SCENARIO_ARROW_STORM, 2000,   1000, 60 },
+    { "melee_clump",     SCENARIO_MELEE_CLUMP, 1000,   1000, 60 },
+    { "terrain_150",     SCENARIO_TERRAIN,     150,    200,  5 },
+    { "terrain_500",     SCENARIO_TERRAIN,     500,    50,   2 },
+    { "terrain_1000",    SCENARIO_TERRAIN,     1000,   20,   1 },
+    { "terrain_2000",    SCENARIO_TERRAIN,     2000,   10,   1 }
+};
+static const size_t SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+// Area of arena given to each enemy in the swarm scenarios
+static const float AREA_PER_ENEMY = 0.05f;
+
+struct Result {
+    std::string name;
+    int count;
+    long ticks;
+    double nsPerTick;
+    double ticksPerSec;
+    double p50;
+    double p99;
+    double allocsPerTick;
+    double bytesPerTick;
+};
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    if (rank > 0) rank--;
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+static Result summarize(const char* name, int count, std::vector<double>& samples,
+                        unsigned long long allocs, unsigned long long bytes) {
+    double totalNs = 0.0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        totalNs += samples[i];
+    }
+    double ticks = static_cast<double>(samples.size());
+
+    Result result;
+    result.name = name;
+    result.count = count;
+    result.ticks = static_cast<long>(samples.size());
+    result.nsPerTick = totalNs / ticks;
+    result.ticksPerSec = totalNs > 0.0 ? ticks * 1e9 / totalNs : 0.0;
+    result.allocsPerTick = allocs / ticks;
+    result.bytesPerTick = bytes / ticks;
+    std::sort(samples.begin(), samples.end());
+    result.p50 = percentile(samples, 0.50);
+    result.p99 = percentile(samples, 0.99);
+    return result;
+}
+
+static SimulationConfig scenarioConfig(const Scenario& scenario, int workerThreads) {
+    SimulationConfig config;
+    config.verbose = false;
+    config.seed = 1;
+    config.workerThreads = workerThreads;
+    config.initialEnemies = scenario.count;
+    config.maxEnemies = scenario.count;
+    config.enemiesToKill = 1 << 30;  // Never win, never respawn past the cap
+
+    if (scenario.kind == SCENARIO_SWARM) {
+        // Grow the arena (keeping its aspect) so density stays constant
+        float aspect = config.arenaHalfWidth / config.arenaHalfHeight;
+        float area = scenario.count * AREA_PER_ENEMY;
+        float halfHeight = std::sqrt(area / (4.0f * aspect));
+        if (halfHeight > config.arenaHalfHeight) {
+            config.arenaHalfHeight = halfHeight;
+            config.arenaHalfWidth = halfHeight * aspect;
+        }
+    } else if (scenario.kind == SCENARIO_ARROW_STORM) {
+        config.maxProjectiles = 65536;
+    }
+    return config;
+}
+
+// Move every enemy to the scenario's starting layout
+static void placeEnemies(Simulation& sim, const Scenario& scenario) {
+    const SimulationConfig& config = sim.getConfig();
+    Rng rng(deriveSeed(config.seed, 0xBE7C));
+    EnemyPool& enemies = sim.enemies;
+
+    for (size_t i = 0; i < enemies.size(); i++) {
+        float x = 0.0f, y = 0.0f;
+        if (scenario.kind == SCENARIO_SWARM) {
+            x = rng.range(-config.arenaHalfWidth, config.arenaHalfWidth);
+            y = rng.range(-config.arenaHalfHeight, config.arenaHalfHeight);
+        } else if (scenario.kind == SCENARIO_ARROW_STORM) {
+            float angle = rng.range(0.0f, 2 * 3.14159f);
+            float distance = rng.range(0.35f, 0.45f);
+            x = std::cos(angle) * distance;
+            y = std::sin(angle) * distance;
+        } else if (scenario.kind == SCENARIO_MELEE_CLUMP) {
+            float angle = rng.range(0.0f, 2 * 3.14159f);
+            float distance = rng.range(0.0f, 0.1f);
+            x = std::cos(angle) * distance;
+            y = std::sin(angle) * distance;
+        }
+        enemies.x[i] = enemies.prevX[i] = x;
+        enemies.y[i] = enemies.prevY[i] = y;
+        enemies.brain[i].homeX = x;
+        enemies.brain[i].homeY = y;
+    }
+}
+
+// Player input for one tick: the storm keeps shooting in a sweeping arc,
+// the clump keeps swinging; the swarms stand still
+static InputState scenarioInput(const Scenario& scenario, long tick) {
+    InputState input;
+    float angle = tick * 0.05f;
+    input.aimX = std::cos(angle);
+    input.aimY = std::sin(angle);
+    if (scenario.kind == SCENARIO_ARROW_STORM) {
+        input.fireArrow = (tick % 2) == 0;  // Debounced, so toggle
+    } else if (scenario.kind == SCENARIO_MELEE_CLUMP) {
+        input.swingSword = (tick % 2) == 0;
+    }
+    return input;
+}
+
+static Result runSimulation(const Scenario& scenario, double ticksScale, int workerThreads) {
+    Simulation sim(scenarioConfig(scenario, workerThreads));
+    placeEnemies(sim, scenario);
+
+    long ticks = std::max(1L, static_cast<long>(scenario.ticks * ticksScale));
+    std::vector<double> samples;
+    samples.reserve(ticks);
+
+    unsigned long long allocsBefore = 0, bytesBefore = 0;
+    for (long tick = -scenario.warmup; tick < ticks; tick++) {
+        // Keep the player alive so every tick exercises the full pipeline
+        sim.player.currentHealth = sim.player.maxHealth;
+        sim.player.isDead = false;
+        InputState input = scenarioInput(scenario, tick);
+
+        if (tick == 0) {
+            allocsBefore = allocationCount.load();
+            bytesBefore = allocationBytes.load();
+        }
+        auto start = std::chrono::steady_clock::now();
+        sim.step(input);
+        auto end = std::chrono::steady_clock::now();
+
+        if (tick >= 0) {
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            samples.push_back(ns);
+        }
+    }
+
+    unsigned long long allocs = allocationCount.load() - allocsBefore;
+    unsigned long long bytes = allocationBytes.load() - bytesBefore;
+    return summarize(scenario.name, scenario.count, samples, allocs, bytes);
+}
+
+// Terrain does not take part in ticks; each "tick" here is one full
+// generation and mesh bake at the scenario's element count
+static Result runTerrain(const Scenario& scenario, double ticksScale) {
+    TerrainSettings settings;
+    settings.elementCount = scenario.count;
+    // Shrink the spacing with the count so the layout stays placeable
+    settings.minDistance = 0.15f * std::sqrt(150.0f / scenario.count);
+
+    long ticks = std::max(1L, static_cast<long>(scenario.ticks * ticksScale));
+    std::vector<TerrainElement> elements;
+    elements.reserve(scenario.count);
+    std::vector<TerrainVertex> mesh;
+    std::vector<double> samples;
+    samples.reserve(ticks);
+
+    unsigned long long allocsBefore = 0, bytesBefore = 0;
+    for (long tick = -scenario.warmup; tick < ticks; tick++) {
+        if (tick == 0) {
+            allocsBefore = allocationCount.load();
+            bytesBefore = allocationBytes.load();
+        }
+        uint64_t seed = static_cast<uint64_t>(tick + scenario.warmup + 1);
+        auto start = std::chrono::steady_clock::now();
+        generateTerrain(settings, seed, elements);
+        buildTerrainMesh(elements, mesh);
+        auto end = std::chrono::steady_clock::now();
+
+        if (tick >= 0) {
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            samples.push_back(ns);
+        }
+    }
+
+    unsigned long long allocs = allocationCount.load() - allocsBefore;
+    unsigned long long bytes = allocationBytes.load() - bytesBefore;
+    return summarize(scenario.name, static_cast<int>(elements.size()), samples, allocs, bytes);
+}
+
+static std::string toJson(const std::vector<Result>& results, int threads) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    out << "{\n";
+    out << "  \"threads\": " << threads << ",\n";
+    out << "  \"perception_kernel\": \"" << perceptionKernelName() << "\",\n";
+    out << "  \"scenarios\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n");
+        out << "    {\"name\": \"" << r.name << "\", \"entities\": " << r.count
+            << ", \"ticks\": " << r.ticks
+            << ", \"ns_per_tick\": " << r.nsPerTick
+            << ", \"ticks_per_sec\": " << r.ticksPerSec
+            << ", \"p50_ns\": " << r.p50
+            << ", \"p99_ns\": " << r.p99;
+        out.precision(3);
+        out << ", \"allocs_per_tick\": " << r.allocsPerTick
+            << ", \"bytes_per_tick\": " << r.bytesPerTick << "}";
+        out.precision(1);
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* outPath = nullptr;
+    double ticksScale = 1.0;
+    int workerThreads = SimulationConfig().workerThreads;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--scenario") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--ticks-scale") == 0 && hasValue) {
+            ticksScale = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            int threads = std::atoi(argv[++i]);
+            if (threads < 1) {
+                std::cerr << "--threads needs at least 1 thread" << std::endl;
+                return 1;
+            }
+            workerThreads = threads - 1;
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+                std::cout << SCENARIOS[s].name << std::endl;
+            }
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        const Scenario& scenario = SCENARIOS[s];
+        if (filter && !std::strstr(scenario.name, filter)) continue;
+
+        std::cerr << "Running " << scenario.name << "..." << std::endl;
+        if (scenario.kind == SCENARIO_TERRAIN) {
+            results.push_back(runTerrain(scenario, ticksScale));
+        } else {
+            results.push_back(runSimulation(scenario, ticksScale, workerThreads));
+        }
+    }
+    // Report the thread count the simulation actually ends up with
+    int threads = JobSystem(workerThreads).threadCount();
+    std::string json = toJson(results, threads);
+    if (outPath) {
+        std::ofstream file(outPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write benchmark results: " << outPath << std::endl;
+            return 1;
+        }
+        file << json;
+    } else {
+        std::cout << json;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Checks for EnemyPool's swap-and-pop removal and generational handles.
+// Built as knighted_enemy_pool_test and run by ctest; prints each failed
+// check and exits non-zero if any failed.
+#include "EnemyPool.h"
+#include <iostream>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: "     \
+                      << #condition << std::endl;                              \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static EnemyHandle spawn(EnemyPool& pool, float x) {
+    return pool.add(x, 0.0f, 0.05f, 0.5f, 1);
+}
+
+int main() {
+    EnemyPool pool;
+    EnemyHandle a = spawn(pool, 1.0f);
+    EnemyHandle b = spawn(pool, 2.0f);
+    EnemyHandle c = spawn(pool, 3.0f);
+
+    // Fresh handles resolve to their dense index
+    CHECK(pool.size() == 3);
+    CHECK(pool.indexOf(a) == 0);
+    CHECK(pool.indexOf(b) == 1);
+    CHECK(pool.indexOf(c) == 2);
+    CHECK(pool.handleAt(1).slot == b.slot && pool.handleAt(1).generation == b.generation);
+
+    // Removing the first enemy moves the last one into its place; the
+    // moved enemy's handle follows it and the removed one goes stale
+    pool.remove(0);
+    CHECK(pool.size() == 2);
+    CHECK(!pool.isValid(a));
+    CHECK(pool.indexOf(a) == EnemyPool::npos);
+    CHECK(pool.indexOf(c) == 0);
+    CHECK(pool.x[0] == 3.0f);
+    CHECK(pool.indexOf(b) == 1);
+    CHECK(pool.x[1] == 2.0f);
+
+    // A new enemy reuses the free slot under a new generation, so the old
+    // handle to that slot stays stale
+    EnemyHandle d = spawn(pool, 4.0f);
+    CHECK(d.slot == a.slot);
+    CHECK(d.generation != a.generation);
+    CHECK(!pool.isValid(a));
+    CHECK(pool.indexOf(d) == 2);
+    CHECK(pool.x[2] == 4.0f);
+
+    // Removing the last enemy moves nothing
+    pool.remove(2);
+    CHECK(!pool.isValid(d));
+    CHECK(pool.indexOf(c) == 0);
+    CHECK(pool.indexOf(b) == 1);
+
+    // A slot that was never handed out is not valid
+    EnemyHandle bogus = { 1000, 0 };
+    CHECK(!pool.isValid(bogus));
+    CHECK(pool.indexOf(bogus) == EnemyPool::npos);
+
+    // Clearing invalidates every handle
+    pool.clear();
+    CHECK(pool.empty());
+    CHECK(!pool.isValid(b));
+    CHECK(!pool.isValid(c));
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "EnemyPool checks passed" << std::endl;
+    return 0;
+}
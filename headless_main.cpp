@@ -0,0 +1,144 @@
+// Headless driver: runs the game simulation without a window or GPU.
+// Useful for soak tests and quick throughput checks on build machines.
+//
+// Usage: knighted_headless [--ticks N] [--tick-rate HZ] [--seed N]
+//                          [--max-enemies N] [--kills N] [--threads N]
+//                          [--record FILE] [--replay FILE] [--verbose]
+//
+// --threads is the total thread count including the main thread (at least
+// 1; without it, one per core). --record saves the scripted input of the
+// run; --replay runs a recording (from here or from the game) with its
+// settings and seed instead of the scripted player.
+#include "Simulation.h"
+#include "InputRecording.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Scripted player: circles the arena, shoots at the nearest enemy and
+// swings the sword whenever something gets close.
+static InputState scriptedInput(const Simulation& sim, long tick) {
+    InputState input;
+
+    // Walk in a slow square so the player keeps moving through the arena
+    int leg = static_cast<int>((tick / 120) % 4);
+    input.moveUp = (leg == 0);
+    input.moveRight = (leg == 1);
+    input.moveDown = (leg == 2);
+    input.moveLeft = (leg == 3);
+
+    // Aim at the nearest living enemy
+    float bestDist = -1.0f;
+    const EnemyPool& enemies = sim.enemies;
+    for (size_t i = 0; i < enemies.size(); i++) {
+        if (enemies.isDead(i)) continue;
+        float dx = enemies.x[i] - sim.player.x;
+        float dy = enemies.y[i] - sim.player.y;
+        float dist = dx * dx + dy * dy;
+        if (bestDist < 0.0f || dist < bestDist) {
+            bestDist = dist;
+            input.aimX = enemies.x[i];
+            input.aimY = enemies.y[i];
+        }
+    }
+
+    if (bestDist >= 0.0f) {
+        // Toggle the button so the debounced fire triggers repeatedly
+        input.fireArrow = (tick % 2) == 0;
+        input.swingSword = bestDist < 0.2f * 0.2f && (tick % 2) == 0;
+    }
+    return input;
+}
+
+int main(int argc, char** argv) {
+    long ticks = 10000;
+    SimulationConfig config;
+    config.verbose = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) {
+            ticks = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            float tickRate = static_cast<float>(std::atof(argv[++i]));
+            if (!(tickRate > 0.0f) || !std::isfinite(tickRate)) {
+                std::cerr << "--tick-rate needs a positive number of ticks per second" << std::endl;
+                return 1;
+            }
+            config.tickRate = tickRate;
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = static_cast<uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-enemies") == 0 && hasValue) {
+            config.maxEnemies = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--kills") == 0 && hasValue) {
+            config.enemiesToKill = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            int threads = std::atoi(argv[++i]);
+            if (threads < 1) {
+                std::cerr << "--threads needs at least 1 thread" << std::endl;
+                return 1;
+            }
+            config.workerThreads = threads - 1;
+        } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            config.verbose = true;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    InputReplay replay;
+    if (replayPath) {
+        if (!replay.load(replayPath)) {
+            return 1;
+        }
+        replay.applyTo(config);
+        ticks = replay.getTickCount();
+    }
+
+    InputRecorder recorder;
+    if (recordPath && !recorder.open(recordPath, config)) {
+        return 1;
+    }
+
+    Simulation sim(config);
+
+    auto start = std::chrono::steady_clock::now();
+    long tick = 0;
+    for (; tick < ticks; tick++) {
+        InputState input;
+        if (replayPath) {
+            if (!replay.next(input)) break;
+        } else {
+            input = scriptedInput(sim, tick);
+        }
+        recorder.record(input);
+        sim.step(input);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (!recorder.close()) {
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Threads:        " << sim.getThreadCount() << std::endl;
+    std::cout << "Ticks:          " << tick << std::endl;
+    std::cout << "Simulated time: " << sim.time << " s" << std::endl;
+    std::cout << "Wall time:      " << seconds << " s" << std::endl;
+    if (seconds > 0.0) {
+        std::cout << "Ticks/sec:      " << static_cast<long>(tick / seconds) << std::endl;
+    }
+    std::cout << "Kills:          " << sim.totalEnemiesKilled << "/" << sim.enemiesToKill << std::endl;
+    std::cout << "Player health:  " << sim.player.currentHealth << "/" << sim.player.maxHealth << std::endl;
+    std::cout << "Outcome:        " << (sim.gameWon ? "won" : (sim.player.isDead ? "dead" : "running")) << std::endl;
+    return 0;
+}
@@ -1,13 +1,60 @@
 #include "Game.h"
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 
-int main() {
+// Usage: CG_Project [--record FILE] [--replay FILE] [--seed N]
+//                   [--offscreen FRAMES] [--egl] [--frames-dir DIR] [--golden DIR]
+//
+// --offscreen renders FRAMES frames into a hidden window's framebuffer
+// (fixed seed, one tick per frame) and prints render times as JSON;
+// --frames-dir saves them as PNGs and --golden compares them with the
+// PNGs saved by an earlier run. --egl creates the context through EGL.
+int main(int argc, char** argv) {
     Game game;
+    bool offscreen = false;
+    bool useEgl = false;
+    int frames = 0;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            game.setRecordPath(argv[++i]);
+        } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+            game.setReplayPath(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            game.setSeed(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--offscreen") == 0 && hasValue) {
+            offscreen = true;
+            frames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--egl") == 0) {
+            useEgl = true;
+        } else if (std::strcmp(argv[i], "--frames-dir") == 0 && hasValue) {
+            game.setFramesDir(argv[++i]);
+        } else if (std::strcmp(argv[i], "--golden") == 0 && hasValue) {
+            game.setGoldenDir(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+    if (offscreen) {
+        if (frames <= 0) {
+            std::cerr << "--offscreen needs a positive frame count" << std::endl;
+            return -1;
+        }
+        game.setOffscreen(frames, useEgl);
+    }
+
     if (!game.init()) {
         std::cerr << "Game initialization failed!" << std::endl;
         return -1;
     }
-    game.run();
+    int result = 0;
+    if (offscreen) {
+        result = game.runOffscreen() ? 0 : 1;
+    } else {
+        game.run();
+    }
     game.cleanup();
-    return 0;
+    return result;
 }
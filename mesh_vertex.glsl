@@ -0,0 +1,19 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec3 aColor;      // Per vertex color
+
+uniform mat4 uModel;
+
+layout(std140) uniform FrameData {
+    mat4 uProjection;      // World space -> clip space
+    mat4 uTextProjection;  // Screen pixels -> clip space
+    float uTime;
+};
+
+out vec3 vColor;
+
+void main()
+{
+    vColor = aColor;
+    gl_Position = uProjection * uModel * vec4(aPos, 0.0, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+in vec2 vTexCoord;
+in vec4 vColor;
+in vec2 vFill;
+out vec4 FragColor;
+
+uniform sampler2D uTexture;   // 1x1 white for solid quads
+
+void main()
+{
+    // Partially filled quads (graph bars) are cut off at the fill fraction
+    if (vFill.x > vFill.y) {
+        discard;
+    }
+    FragColor = vColor * texture(uTexture, vTexCoord);
+}
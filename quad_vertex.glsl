@@ -0,0 +1,23 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec4 aColor;
+layout(location = 3) in vec2 aFill;    // x: 0 at the quad's left edge, 1 at its right; y: visible fraction
+
+layout(std140) uniform FrameData {
+    mat4 uProjection;      // World space -> clip space
+    mat4 uTextProjection;  // Screen pixels -> clip space
+    float uTime;
+};
+
+out vec2 vTexCoord;
+out vec4 vColor;
+out vec2 vFill;
+
+void main()
+{
+    vTexCoord = aTexCoord;
+    vColor = aColor;
+    vFill = aFill;
+    gl_Position = uProjection * vec4(aPos, 0.0, 1.0);
+}
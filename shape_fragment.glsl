@@ -0,0 +1,27 @@
+#version 330 core
+in vec2 vLocal;
+in vec4 vShape;
+in vec4 vColor;
+out vec4 FragColor;
+
+void main()
+{
+    // Signed distance to a rounded box; a circle is a square whose corner
+    // radius is its half size, a capsule a box rounded along its short side
+    vec2 halfSize = vShape.xy;
+    float radius = min(vShape.z, min(halfSize.x, halfSize.y));
+    vec2 q = abs(vLocal) - halfSize + radius;
+    float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+
+    // Rings keep only a band of the given thickness around the edge
+    if (vShape.w > 0.0) {
+        dist = abs(dist) - 0.5 * vShape.w;
+    }
+
+    // One pixel wide antialiased edge
+    float coverage = clamp(0.5 - dist / fwidth(dist), 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    FragColor = vec4(vColor.rgb, vColor.a * coverage);
+}
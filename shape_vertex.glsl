@@ -0,0 +1,23 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;      // World position of the quad corner
+layout(location = 1) in vec2 aLocal;    // Same corner in the shape's own frame (centered, unrotated)
+layout(location = 2) in vec4 aShape;    // Half width, half height, corner radius, ring thickness
+layout(location = 3) in vec4 aColor;
+
+layout(std140) uniform FrameData {
+    mat4 uProjection;      // World space -> clip space
+    mat4 uTextProjection;  // Screen pixels -> clip space
+    float uTime;
+};
+
+out vec2 vLocal;
+out vec4 vShape;
+out vec4 vColor;
+
+void main()
+{
+    vLocal = aLocal;
+    vShape = aShape;
+    vColor = aColor;
+    gl_Position = uProjection * vec4(aPos, 0.0, 1.0);
+}
@@ -1,8 +1,8 @@
 #version 330 core
-in vec2 TexCoords;
+in vec3 TexCoords;
 out vec4 color;
 
-uniform sampler2D text;
+uniform sampler2DArray text;   // Glyph cache pages
 uniform vec3 textColor;
 
 void main()
@@ -0,0 +1,33 @@
+#version 330 core
+in vec3 TexCoords;
+out vec4 color;
+
+uniform sampler2DArray text;   // Signed distance fields, 0.5 on the glyph edge
+uniform vec3 textColor;
+uniform vec3 outlineColor;
+uniform float outlineWidth;    // In distance units outside the edge (0 = none)
+uniform vec4 glowColor;        // Alpha is the glow strength
+uniform float glowWidth;       // In distance units outside the outline (0 = none)
+
+void main()
+{
+    float dist = texture(text, TexCoords).r;
+    
+    // One screen pixel of antialiasing at any scale
+    float aa = max(fwidth(dist) * 0.5, 1e-4);
+    
+    float fill = smoothstep(0.5 - aa, 0.5 + aa, dist);
+    float outlineEdge = 0.5 - outlineWidth;
+    float outline = outlineWidth > 0.0 ? smoothstep(outlineEdge - aa, outlineEdge + aa, dist) : 0.0;
+    
+    // Glyph body: fill over its outline
+    vec3 bodyColor = mix(outlineColor, textColor, fill);
+    float bodyAlpha = max(fill, outline);
+    
+    // Soft glow fading out beyond the outline, composited under the body
+    float glow = glowWidth > 0.0 ? smoothstep(outlineEdge - glowWidth, outlineEdge, dist) * glowColor.a : 0.0;
+    float alpha = bodyAlpha + glow * (1.0 - bodyAlpha);
+    vec3 rgb = (bodyColor * bodyAlpha + glowColor.rgb * glow * (1.0 - bodyAlpha)) / max(alpha, 1e-4);
+    
+    color = vec4(rgb, alpha);
+}
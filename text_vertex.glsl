@@ -1,12 +1,19 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in float page;  // Glyph cache page (array layer)
 
-out vec2 TexCoords;
+out vec3 TexCoords;
 
-uniform mat4 projection;
+uniform vec2 textOffset;   // Pixels added to every vertex (cached layouts)
+
+layout(std140) uniform FrameData {
+    mat4 uProjection;      // World space -> clip space
+    mat4 uTextProjection;  // Screen pixels -> clip space
+    float uTime;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    gl_Position = uTextProjection * vec4(vertex.xy + textOffset, 0.0, 1.0);
+    TexCoords = vec3(vertex.zw, page);
 } 
\ No newline at end of file